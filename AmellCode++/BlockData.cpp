@@ -0,0 +1,24 @@
+#include "BlockData.h"
+#include "CompletionIndex.h"
+
+BlockData::~BlockData() {
+    if (!words.isEmpty())
+        CompletionIndex::instance().removeWords(words);
+    if (bracketNode) {
+        if (auto index = bracketIndex.lock())
+            index->remove(bracketNode);
+    }
+}
+
+BlockData *BlockData::of(const QTextBlock &block) {
+    return static_cast<BlockData *>(block.userData());
+}
+
+BlockData *BlockData::ensure(QTextBlock &block) {
+    BlockData *data = of(block);
+    if (!data) {
+        data = new BlockData;
+        block.setUserData(data);
+    }
+    return data;
+}
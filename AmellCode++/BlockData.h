@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QTextBlock>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+#include "BracketIndex.h"
+
+// Token semántico recibido del servidor de lenguaje (clangd)
+struct SemanticToken {
+    enum Kind { Type, Namespace, Function, Macro, Variable, KindCount };
+
+    int line = 0;
+    int start = 0;
+    int length = 0;
+    Kind kind = Variable;
+
+    bool operator==(const SemanticToken &o) const {
+        return line == o.line && start == o.start && length == o.length && kind == o.kind;
+    }
+};
+
+// Corchete fuera de comentarios y cadenas, según el escaneo del highlighter
+struct Bracket {
+    int position;   // relativa al inicio del bloque
+    char16_t ch;
+};
+
+// Datos asociados a cada bloque (línea) del documento.
+// QTextDocument destruye el objeto cuando el bloque desaparece, así que
+// cualquier índice que dependa de un bloque se limpia en el destructor.
+class BlockData : public QTextBlockUserData {
+public:
+    ~BlockData() override;
+
+    static BlockData *of(const QTextBlock &block);
+    static BlockData *ensure(QTextBlock &block);
+
+    // A partir de LONG_LINE caracteres una línea se considera patológica
+    // (JSON minificado, código generado): solo se resalta una ventana de
+    // HIGHLIGHT_WINDOW caracteres que sigue al cursor
+    static constexpr int LONG_LINE = 10000;
+    static constexpr int HIGHLIGHT_WINDOW = 8192;
+    static bool isLong(const QTextBlock &block) { return block.length() > LONG_LINE; }
+
+    // Identificadores del bloque registrados en CompletionIndex
+    QStringList words;
+
+    // Tokens semánticos de la última respuesta y revisión del bloque a la
+    // que corresponden; si el bloque cambió se ignoran hasta la siguiente
+    QVector<SemanticToken> semanticTokens;
+    int semanticRevision = -1;
+
+    // Corchetes del bloque y su nodo en el BracketIndex del documento
+    QVector<Bracket> brackets;
+    BracketIndex::Node *bracketNode = nullptr;
+    std::weak_ptr<BracketIndex> bracketIndex;
+
+    // El bloque inicia un pliegue cerrado
+    bool folded = false;
+
+    // Inicio de la ventana resaltada si el bloque es una línea larga
+    int highlightStart = 0;
+};
@@ -0,0 +1,304 @@
+#include "BracketIndex.h"
+#include "BlockData.h"
+
+#include <QTextDocument>
+
+#include <algorithm>
+
+struct BracketIndex::Node {
+    Node *left = nullptr;
+    Node *right = nullptr;
+    Node *parent = nullptr;
+    quint32 priority = 0;
+    int size = 1;
+    Stats own[KindCount];
+    Stats agg[KindCount];   // agregado del subárbol (en orden)
+};
+
+namespace {
+
+using Node = BracketIndex::Node;
+using Stats = BracketIndex::Stats;
+
+int sizeOf(const Node *t) { return t ? t->size : 0; }
+
+Stats combine(const Stats &a, const Stats &b) {
+    return { a.delta + b.delta, std::min(a.minPrefix, a.delta + b.minPrefix) };
+}
+
+void pull(Node *t) {
+    t->size = 1 + sizeOf(t->left) + sizeOf(t->right);
+    for (int k = 0; k < BracketIndex::KindCount; ++k) {
+        Stats s = t->left ? t->left->agg[k] : Stats();
+        s = combine(s, t->own[k]);
+        if (t->right) s = combine(s, t->right->agg[k]);
+        t->agg[k] = s;
+    }
+    if (t->left) t->left->parent = t;
+    if (t->right) t->right->parent = t;
+}
+
+// Los primeros k nodos van a 'a', el resto a 'b'
+void split(Node *t, int k, Node *&a, Node *&b) {
+    if (!t) { a = b = nullptr; return; }
+    if (sizeOf(t->left) >= k) {
+        split(t->left, k, a, t->left);
+        b = t;
+    } else {
+        split(t->right, k - sizeOf(t->left) - 1, t->right, b);
+        a = t;
+    }
+    pull(t);
+}
+
+Node *merge(Node *a, Node *b) {
+    if (!a) return b;
+    if (!b) return a;
+    if (a->priority > b->priority) {
+        a->right = merge(a->right, b);
+        pull(a);
+        return a;
+    }
+    b->left = merge(a, b->left);
+    pull(b);
+    return b;
+}
+
+void destroy(Node *t) {
+    if (!t) return;
+    destroy(t->left);
+    destroy(t->right);
+    delete t;
+}
+
+} // namespace
+
+BracketIndex::~BracketIndex() {
+    destroy(m_root);
+}
+
+BracketIndex::Kind BracketIndex::kindOf(char16_t c) {
+    switch (c) {
+    case u'{': case u'}': return Curly;
+    case u'(': case u')': return Paren;
+    case u'[': case u']': return Square;
+    default: return KindCount;
+    }
+}
+
+bool BracketIndex::isOpen(char16_t c) {
+    return c == u'{' || c == u'(' || c == u'[';
+}
+
+// ---------- Mantenimiento ----------
+
+BracketIndex::Node *BracketIndex::insert(int rank) {
+    Node *n = new Node;
+    // xorshift: prioridades aleatorias baratas y deterministas
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    n->priority = m_seed;
+
+    Node *a, *b;
+    split(m_root, qBound(0, rank, size()), a, b);
+    m_root = merge(merge(a, n), b);
+    m_root->parent = nullptr;
+    return n;
+}
+
+void BracketIndex::remove(Node *node) {
+    Node *a, *b, *mid, *c;
+    split(m_root, rank(node), a, b);
+    split(b, 1, mid, c);
+    delete mid;
+    m_root = merge(a, c);
+    if (m_root) m_root->parent = nullptr;
+}
+
+void BracketIndex::update(Node *node, const Stats stats[KindCount]) {
+    std::copy(stats, stats + KindCount, node->own);
+    for (Node *x = node; x; x = x->parent) pull(x);
+}
+
+int BracketIndex::rank(const Node *node) const {
+    int r = sizeOf(node->left);
+    for (const Node *x = node; x->parent; x = x->parent) {
+        if (x == x->parent->right) r += sizeOf(x->parent->left) + 1;
+    }
+    return r;
+}
+
+int BracketIndex::size() const {
+    return sizeOf(m_root);
+}
+
+// ---------- Búsquedas en el árbol ----------
+
+// Suma de deltas de los bloques [0, rank)
+int BracketIndex::depthBefore(int rank, Kind kind) const {
+    int sum = 0;
+    const Node *t = m_root;
+    while (t) {
+        const int ls = sizeOf(t->left);
+        if (rank <= ls) {
+            t = t->left;
+        } else {
+            sum += (t->left ? t->left->agg[kind].delta : 0) + t->own[kind].delta;
+            rank -= ls + 1;
+            t = t->right;
+        }
+    }
+    return sum;
+}
+
+// Primer bloque >= from cuya profundidad mínima absoluta baja de 'depth'
+int BracketIndex::findFirstBelow(int from, int depth, Kind kind) const {
+    struct Walker {
+        int from, depth;
+        Kind kind;
+        int run(const Node *t, int base, int offset) const {
+            if (!t || base + t->size - 1 < from) return -1;
+            if (base >= from && offset + t->agg[kind].minPrefix >= depth) return -1;
+            const int r = run(t->left, base, offset);
+            if (r >= 0) return r;
+            const int selfRank = base + sizeOf(t->left);
+            const int selfOffset = offset + (t->left ? t->left->agg[kind].delta : 0);
+            if (selfRank >= from && selfOffset + t->own[kind].minPrefix < depth) return selfRank;
+            return run(t->right, selfRank + 1, selfOffset + t->own[kind].delta);
+        }
+    };
+    return Walker{from, depth, kind}.run(m_root, 0, 0);
+}
+
+// Último bloque <= to cuya profundidad mínima absoluta es <= 'depth'
+int BracketIndex::findLastAtMost(int to, int depth, Kind kind) const {
+    struct Walker {
+        int to, depth;
+        Kind kind;
+        int run(const Node *t, int base, int offset) const {
+            if (!t || base > to) return -1;
+            if (base + t->size - 1 <= to && offset + t->agg[kind].minPrefix > depth) return -1;
+            const int selfRank = base + sizeOf(t->left);
+            const int selfOffset = offset + (t->left ? t->left->agg[kind].delta : 0);
+            const int r = run(t->right, selfRank + 1, selfOffset + t->own[kind].delta);
+            if (r >= 0) return r;
+            if (selfRank <= to && selfOffset + t->own[kind].minPrefix <= depth) return selfRank;
+            return run(t->left, base, offset);
+        }
+    };
+    return Walker{to, depth, kind}.run(m_root, 0, 0);
+}
+
+// ---------- Escaneo dentro de un bloque ----------
+
+// Primer corchete desde 'fromIndex' tras el que la profundidad queda < target
+int BracketIndex::scanForward(const QTextDocument *doc, int blockNumber, int fromIndex,
+                              int depth, int target, Kind kind) const {
+    const QTextBlock block = doc->findBlockByNumber(blockNumber);
+    const BlockData *data = BlockData::of(block);
+    if (!data) return -1;
+    for (int j = fromIndex; j < data->brackets.size(); ++j) {
+        const Bracket &b = data->brackets[j];
+        if (kindOf(b.ch) != kind) continue;
+        depth += isOpen(b.ch) ? 1 : -1;
+        if (depth < target) return block.position() + b.position;
+    }
+    return -1;
+}
+
+// Último corchete antes de 'beforeIndex' cuya profundidad previa es <= target
+int BracketIndex::scanBackward(const QTextDocument *doc, int blockNumber, int beforeIndex,
+                               int target, Kind kind) const {
+    const QTextBlock block = doc->findBlockByNumber(blockNumber);
+    const BlockData *data = BlockData::of(block);
+    if (!data || !data->bracketNode) return -1;
+    int depth = depthBefore(rank(data->bracketNode), kind);
+    const int end = beforeIndex < 0 ? data->brackets.size() : beforeIndex;
+    int found = -1;
+    for (int j = 0; j < end; ++j) {
+        const Bracket &b = data->brackets[j];
+        if (kindOf(b.ch) != kind) continue;
+        if (depth <= target) found = block.position() + b.position;
+        depth += isOpen(b.ch) ? 1 : -1;
+    }
+    return found;
+}
+
+// ---------- Consultas ----------
+
+int BracketIndex::matchBracket(const QTextDocument *doc, int position) const {
+    const QTextBlock block = doc->findBlock(position);
+    const BlockData *data = BlockData::of(block);
+    if (!data || !data->bracketNode) return -1;
+
+    const int inBlock = position - block.position();
+    const auto it = std::lower_bound(data->brackets.cbegin(), data->brackets.cend(), inBlock,
+                                     [](const Bracket &b, int pos) { return b.position < pos; });
+    if (it == data->brackets.cend() || it->position != inBlock) return -1;
+    const int index = static_cast<int>(it - data->brackets.cbegin());
+    const Kind kind = kindOf(it->ch);
+
+    const int blockRank = rank(data->bracketNode);
+    int depth = depthBefore(blockRank, kind);
+    for (int j = 0; j < index; ++j) {
+        const Bracket &b = data->brackets[j];
+        if (kindOf(b.ch) == kind) depth += isOpen(b.ch) ? 1 : -1;
+    }
+
+    if (isOpen(it->ch)) {
+        const int target = depth + 1;
+        const int local = scanForward(doc, block.blockNumber(), index + 1, target, target, kind);
+        if (local >= 0) return local;
+        const int b = findFirstBelow(blockRank + 1, target, kind);
+        if (b < 0) return -1;
+        return scanForward(doc, b, 0, depthBefore(b, kind), target, kind);
+    }
+
+    const int target = depth - 1;
+    if (target < 0) return -1;
+    const int local = scanBackward(doc, block.blockNumber(), index, target, kind);
+    if (local >= 0) return local;
+    const int b = findLastAtMost(blockRank - 1, target, kind);
+    return b < 0 ? -1 : scanBackward(doc, b, -1, target, kind);
+}
+
+int BracketIndex::enclosingOpen(const QTextDocument *doc, int position) const {
+    const QTextBlock block = doc->findBlock(position);
+    const BlockData *data = BlockData::of(block);
+    if (!data || !data->bracketNode) return -1;
+
+    const int inBlock = position - block.position();
+    const int blockRank = rank(data->bracketNode);
+    int depth = depthBefore(blockRank, Curly);
+    int index = 0;
+    for (; index < data->brackets.size() && data->brackets[index].position < inBlock; ++index) {
+        const Bracket &b = data->brackets[index];
+        if (kindOf(b.ch) == Curly) depth += isOpen(b.ch) ? 1 : -1;
+    }
+
+    const int target = depth - 1;
+    if (target < 0) return -1;
+    const int local = scanBackward(doc, block.blockNumber(), index, target, Curly);
+    if (local >= 0) return local;
+    const int b = findLastAtMost(blockRank - 1, target, Curly);
+    return b < 0 ? -1 : scanBackward(doc, b, -1, target, Curly);
+}
+
+int BracketIndex::foldEnd(const QTextDocument *doc, int blockNumber) const {
+    const QTextBlock block = doc->findBlockByNumber(blockNumber);
+    const BlockData *data = BlockData::of(block);
+    if (!data || !data->bracketNode) return -1;
+
+    // Hay un '{' sin cerrar en la línea si el delta supera al mínimo alcanzado;
+    // el más externo deja la profundidad en before + minPrefix + 1
+    for (Kind kind : {Curly, Directive}) {
+        const Stats &s = data->bracketNode->own[kind];
+        if (s.delta - s.minPrefix <= 0) continue;
+        const int blockRank = rank(data->bracketNode);
+        const int target = depthBefore(blockRank, kind) + s.minPrefix + 1;
+        const int end = findFirstBelow(blockRank + 1, target, kind);
+        return end > blockNumber ? end : -1;
+    }
+    return -1;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QtGlobal>
+
+class QTextDocument;
+
+// Índice de profundidad de corchetes por bloque.
+// Cada bloque aporta, para cada tipo de corchete, su delta neto y la
+// profundidad mínima alcanzada dentro de él (relativa a su inicio). Los
+// bloques viven en un treap implícito ordenado por número de bloque, así
+// que insertar, borrar o actualizar un bloque y buscar el emparejamiento
+// de un corchete cuestan O(log n) en lugar de recorrer el texto.
+class BracketIndex {
+public:
+    // Directive cuenta #if/#ifdef/#ifndef como apertura y #endif como cierre
+    enum Kind { Curly, Paren, Square, Directive, KindCount };
+
+    struct Stats {
+        int delta = 0;      // aperturas - cierres
+        int minPrefix = 0;  // mínimo de la suma parcial (incluye prefijo vacío y completo)
+    };
+
+    struct Node;
+
+    BracketIndex() = default;
+    ~BracketIndex();
+    BracketIndex(const BracketIndex &) = delete;
+    BracketIndex &operator=(const BracketIndex &) = delete;
+
+    // ---------- Mantenimiento (lo llama CppHighlighter) ----------
+    Node *insert(int rank);
+    void remove(Node *node);
+    void update(Node *node, const Stats stats[KindCount]);
+    int rank(const Node *node) const;
+    int size() const;
+
+    // ---------- Consultas ----------
+    // Posición del corchete que empareja con el de 'position' (-1 si no hay)
+    int matchBracket(const QTextDocument *doc, int position) const;
+    // Posición del '{' del ámbito que contiene 'position' (-1 si está fuera de todos)
+    int enclosingOpen(const QTextDocument *doc, int position) const;
+    // Bloque donde se cierra el '{' (o #if) más externo abierto en 'blockNumber' (-1 si no pliega)
+    int foldEnd(const QTextDocument *doc, int blockNumber) const;
+
+    static Kind kindOf(char16_t c);
+    static bool isOpen(char16_t c);
+
+private:
+    int depthBefore(int rank, Kind kind) const;
+    int findFirstBelow(int from, int depth, Kind kind) const;
+    int findLastAtMost(int to, int depth, Kind kind) const;
+    int scanForward(const QTextDocument *doc, int blockNumber, int fromIndex, int depth, int target, Kind kind) const;
+    int scanBackward(const QTextDocument *doc, int blockNumber, int beforeIndex, int target, Kind kind) const;
+
+    Node *m_root = nullptr;
+    quint32 m_seed = 0x9E3779B9u;
+};
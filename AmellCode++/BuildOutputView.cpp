@@ -0,0 +1,136 @@
+#include "BuildOutputView.h"
+
+#include <QFontDatabase>
+#include <QPainter>
+#include <QScrollBar>
+#include <QSettings>
+#include <QTimer>
+
+#include <utility>
+
+BuildOutputView::BuildOutputView(QWidget *parent)
+    : QAbstractScrollArea(parent),
+      m_decoder(QStringDecoder::System),
+      m_frameTimer(new QTimer(this)) {
+    const int capacity = QSettings().value(QStringLiteral("build/outputMaxLines"), DEFAULT_MAX_LINES).toInt();
+    m_lines.resize(qMax(1000, capacity));
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setInterval(FRAME_MS);
+    connect(m_frameTimer, &QTimer::timeout, this, &BuildOutputView::flush);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, viewport(), QOverload<>::of(&QWidget::update));
+}
+
+void BuildOutputView::append(const QByteArray &bytes) {
+    m_pending += bytes;
+    if (!m_frameTimer->isActive()) m_frameTimer->start();
+}
+
+void BuildOutputView::appendLine(const QString &line) {
+    flush();
+    if (!m_partial.isEmpty()) push(std::exchange(m_partial, QString()));
+    push(line);
+    updateScrollBar();
+}
+
+void BuildOutputView::clear() {
+    m_frameTimer->stop();
+    m_pending.clear();
+    m_partial.clear();
+    m_decoder.resetState();
+    for (QString &l : m_lines) l = QString();
+    m_first = 0;
+    m_count = 0;
+    m_dropped = 0;
+    updateScrollBar();
+}
+
+const QString &BuildOutputView::line(int index) const {
+    return m_lines[(m_first + index) % m_lines.size()];
+}
+
+// ---------- Búfer circular ----------
+
+void BuildOutputView::push(QString line) {
+    if (line.size() > MAX_LINE_LENGTH) {
+        line.truncate(MAX_LINE_LENGTH);
+        line += QChar(0x2026);
+    }
+    const int capacity = m_lines.size();
+    if (m_count < capacity) {
+        m_lines[(m_first + m_count) % capacity] = std::move(line);
+        ++m_count;
+    } else {
+        m_lines[m_first] = std::move(line);
+        m_first = (m_first + 1) % capacity;
+        ++m_dropped;
+    }
+}
+
+// Trocea lo recibido en el último fotograma. Si llegaron más líneas de las
+// que caben, las primeras se saltan sin copiarlas al búfer.
+void BuildOutputView::flush() {
+    if (m_pending.isEmpty()) return;
+    QString text = m_partial + m_decoder.decode(m_pending);
+    m_pending.clear();
+    text.remove(QLatin1Char('\r'));
+
+    const int lastNewline = text.lastIndexOf(QLatin1Char('\n'));
+    m_partial = text.mid(lastNewline + 1);
+    // Una línea que nunca termina (barras de progreso) no crece sin límite
+    if (m_partial.size() > MAX_LINE_LENGTH) push(std::exchange(m_partial, QString()));
+    if (lastNewline < 0) {
+        updateScrollBar();
+        return;
+    }
+
+    const QStringView complete = QStringView(text).left(lastNewline);
+    const auto lines = complete.split(QLatin1Char('\n'));
+    const qsizetype skip = qMax<qsizetype>(0, lines.size() - m_lines.size());
+    for (qsizetype i = skip; i < lines.size(); ++i) push(lines[i].toString());
+    updateScrollBar();
+}
+
+// ---------- Vista ----------
+
+int BuildOutputView::visibleRows() const {
+    return qMax(1, viewport()->height() / fontMetrics().height());
+}
+
+// Pegada al final si ya lo estaba; si el usuario subió, las líneas
+// descartadas por arriba no le mueven lo que está leyendo
+void BuildOutputView::updateScrollBar() {
+    QScrollBar *bar = verticalScrollBar();
+    const bool atEnd = bar->value() >= bar->maximum();
+    const int value = bar->value() - m_dropped;
+    m_dropped = 0;
+    bar->setRange(0, qMax(0, m_count - visibleRows()));
+    bar->setPageStep(visibleRows());
+    bar->setValue(atEnd ? bar->maximum() : value);
+    viewport()->update();
+}
+
+void BuildOutputView::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBar();
+}
+
+void BuildOutputView::paintEvent(QPaintEvent *) {
+    QPainter painter(viewport());
+    painter.fillRect(viewport()->rect(), QColor(18, 28, 48));
+
+    const QFontMetrics fm = fontMetrics();
+    const int first = verticalScrollBar()->value();
+    const int last = qMin(m_count, first + visibleRows() + 1);
+    const int x = 4;
+    for (int i = first; i < last; ++i) {
+        const QString &text = line(i);
+        QColor color(220, 230, 245);
+        if (text.contains(QLatin1String("error"), Qt::CaseInsensitive)) color = QColor(240, 110, 110);
+        else if (text.contains(QLatin1String("warning"), Qt::CaseInsensitive)) color = QColor(230, 200, 110);
+        painter.setPen(color);
+        painter.drawText(x, (i - first) * fm.height() + fm.ascent(), text);
+    }
+}
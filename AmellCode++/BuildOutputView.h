@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QByteArray>
+#include <QStringDecoder>
+#include <QVector>
+
+class QTimer;
+
+// Salida del proceso de compilación. Las líneas viven en un búfer circular
+// de capacidad fija (las más antiguas se descartan) y solo se pintan las
+// visibles. append() solo acumula bytes: el troceado en líneas y el
+// repintado se hacen como mucho una vez por fotograma, así que una
+// compilación que escupe un millón de líneas no bloquea la interfaz ni
+// hace crecer la memoria.
+class BuildOutputView : public QAbstractScrollArea {
+    Q_OBJECT
+public:
+    explicit BuildOutputView(QWidget *parent = nullptr);
+
+    void append(const QByteArray &bytes);
+    void appendLine(const QString &line);
+    void clear();
+
+    int lineCount() const { return m_count; }
+    // Línea 'index' contando desde la más antigua que se conserva
+    const QString &line(int index) const;
+
+    static constexpr int DEFAULT_MAX_LINES = 100000;
+    static constexpr int MAX_LINE_LENGTH = 2000;
+    static constexpr int FRAME_MS = 16;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void flush();
+    void push(QString line);
+    void updateScrollBar();
+    int visibleRows() const;
+
+    QVector<QString> m_lines;         // búfer circular
+    int m_first = 0;                  // índice de la línea más antigua
+    int m_count = 0;
+    int m_dropped = 0;                // descartadas desde el último repintado
+
+    QByteArray m_pending;             // bytes recibidos aún sin trocear
+    QString m_partial;                // última línea sin '\n' todavía
+    QStringDecoder m_decoder;
+    QTimer *m_frameTimer;
+};
@@ -0,0 +1,198 @@
+#include "BuildScheduler.h"
+
+#include <QSet>
+
+BuildScheduler::BuildScheduler(QObject *parent)
+    : QObject(parent) {
+}
+
+// Al cerrar no se dejan procesos huérfanos
+BuildScheduler::~BuildScheduler() {
+    for (Entry &e : m_entries) {
+        if (!e.process) continue;
+        e.process->disconnect(this);
+        e.process->kill();
+        e.process->waitForFinished(1000);
+    }
+}
+
+int BuildScheduler::submit(const Job &job) {
+    for (int id : std::as_const(m_order)) {
+        Entry &e = m_entries[id];
+        if (e.state == Queued && e.job.key == job.key) {
+            e.job = job;
+            schedule();
+            return id;
+        }
+    }
+    const int id = m_nextId++;
+    Entry entry;
+    entry.job = job;
+    m_entries.insert(id, entry);
+    m_order.append(id);
+    schedule();
+    return id;
+}
+
+void BuildScheduler::cancel(int id) {
+    auto it = m_entries.find(id);
+    if (it == m_entries.end()) return;
+    if (it->state == Queued) {
+        finish(id, Cancelled);
+    } else if (it->state == Running && it->process) {
+        it->cancelRequested = true;
+        it->process->kill();
+    }
+}
+
+void BuildScheduler::cancelAll() {
+    const QList<int> ids = m_entries.keys();
+    for (int id : ids) cancel(id);
+}
+
+// Una tarea que ya no está (olvidada o que nunca existió) no puede dar por
+// buena a quien dependa de ella
+BuildScheduler::State BuildScheduler::state(int id) const {
+    const auto it = m_entries.constFind(id);
+    return it == m_entries.cend() ? Failed : it->state;
+}
+
+const BuildScheduler::Job *BuildScheduler::job(int id) const {
+    const auto it = m_entries.constFind(id);
+    return it == m_entries.cend() ? nullptr : &it->job;
+}
+
+bool BuildScheduler::isBusy() const {
+    return m_running > 0 || !m_order.isEmpty();
+}
+
+bool BuildScheduler::resourceBusy(const QString &resource) const {
+    if (resource.isEmpty()) return false;
+    for (const Entry &e : m_entries) {
+        if (e.state == Running && e.job.resource == resource) return true;
+    }
+    return false;
+}
+
+// ---------- Planificación ----------
+
+// Recorre la cola en orden de llegada y lanza todo lo que esté listo. Se
+// repite hasta que no cambia nada: cancelar o saltar una tarea puede
+// desbloquear o cancelar otras.
+void BuildScheduler::schedule() {
+    if (m_scheduling) return;
+    m_scheduling = true;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        const QList<int> queued = m_order;
+        for (int id : queued) {
+            Entry &e = m_entries[id];
+            if (e.state != Queued) continue;
+
+            bool ready = true;
+            bool broken = false;
+            for (int dep : std::as_const(e.job.dependencies)) {
+                const State s = state(dep);
+                if (s == Failed || s == Cancelled) broken = true;
+                else if (s != Succeeded) ready = false;
+            }
+            if (broken) {
+                finish(id, Cancelled);
+                changed = true;
+                continue;
+            }
+            if (!ready || m_running >= MAX_PARALLEL || resourceBusy(e.job.resource)) continue;
+            // Una tarea de la misma clave sigue corriendo: esta espera
+            bool sameKeyRunning = false;
+            for (const Entry &other : std::as_const(m_entries)) {
+                if (other.state == Running && other.job.key == e.job.key) sameKeyRunning = true;
+            }
+            if (sameKeyRunning) continue;
+
+            start(id);
+            changed = true;
+        }
+    }
+    m_scheduling = false;
+}
+
+void BuildScheduler::start(int id) {
+    m_order.removeOne(id);
+    m_entries[id].timer.start();
+    emit jobStarted(id);
+    // Se vuelve a buscar: quien atiende la señal puede haber encolado más
+    Entry &e = m_entries[id];
+    if (e.job.condition && !e.job.condition()) {
+        finish(id, Succeeded, true);
+        return;
+    }
+
+    e.state = Running;
+    ++m_running;
+    e.process = new QProcess(this);
+    e.process->setProgram(e.job.program);
+    e.process->setArguments(e.job.arguments);
+    e.process->setWorkingDirectory(e.job.workingDirectory);
+    if (!e.job.environment.isEmpty()) e.process->setProcessEnvironment(e.job.environment);
+    e.process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(e.process, &QProcess::readyReadStandardOutput, this, [this, id]() {
+        emit jobOutput(id, m_entries[id].process->readAllStandardOutput());
+    });
+    connect(e.process, &QProcess::errorOccurred, this, [this, id](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) finish(id, Failed);
+    });
+    connect(e.process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, [this, id](int code, QProcess::ExitStatus status) {
+        const QByteArray rest = m_entries[id].process->readAllStandardOutput();
+        if (!rest.isEmpty()) emit jobOutput(id, rest);
+        if (m_entries[id].cancelRequested) finish(id, Cancelled);
+        else finish(id, status == QProcess::NormalExit && code == 0 ? Succeeded : Failed);
+    });
+    connect(e.process, &QProcess::started, this, [this, id]() {
+        Entry &entry = m_entries[id];
+        if (!entry.job.input.isEmpty()) entry.process->write(entry.job.input);
+        entry.process->closeWriteChannel();
+    });
+    // Si no arranca, FailedToStart llega dentro de start() y la tarea ya
+    // está terminada a la vuelta: no se toca 'e' después
+    e.process->start();
+}
+
+void BuildScheduler::finish(int id, State state, bool skipped) {
+    Entry &e = m_entries[id];
+    if (e.state == Succeeded || e.state == Failed || e.state == Cancelled) return;
+    if (e.state == Running) --m_running;
+    m_order.removeOne(id);
+    e.state = state;
+    if (e.process) {
+        e.process->deleteLater();
+        e.process = nullptr;
+    }
+    e.job.input.clear();
+    const qint64 elapsed = e.timer.isValid() ? e.timer.elapsed() : 0;
+    if (state == Succeeded && e.job.onSuccess) e.job.onSuccess();
+    emit jobFinished(id, state, elapsed, skipped);
+    schedule();
+
+    // Se olvida en la siguiente vuelta del bucle de eventos: quien acaba de
+    // encolar esta tarea aún puede poner otra que dependa de ella
+    if (!m_prunePending) {
+        m_prunePending = true;
+        QMetaObject::invokeMethod(this, &BuildScheduler::prune, Qt::QueuedConnection);
+    }
+}
+
+// Las terminadas de las que no depende ninguna en cola ya no hacen falta
+void BuildScheduler::prune() {
+    m_prunePending = false;
+    QSet<int> needed;
+    for (int id : std::as_const(m_order)) {
+        for (int dep : std::as_const(m_entries[id].job.dependencies)) needed.insert(dep);
+    }
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        const bool terminal = it->state == Succeeded || it->state == Failed || it->state == Cancelled;
+        if (terminal && !needed.contains(it.key())) it = m_entries.erase(it);
+        else ++it;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QStringList>
+#include <functional>
+
+// Cola de tareas externas (configurar, compilar, ejecutar, probar,
+// analizar) como un grafo de dependencias. Una tarea arranca cuando sus
+// dependencias terminaron bien; si alguna falla o se cancela, ella se
+// cancela también. Las que no dependen entre sí corren en paralelo salvo
+// que compartan 'resource' (p. ej. el directorio de compilación), que
+// las serializa.
+//
+// Pedir otra vez una tarea con la misma 'key' mientras la anterior sigue en
+// cola la sustituye; si ya está corriendo no se mata: la nueva espera a
+// que acabe. Toda tarea se puede cancelar y informa de su duración.
+//
+// Las terminadas se olvidan en cuanto ninguna en cola depende de ellas:
+// job() y state() siguen respondiendo por ellas hasta la siguiente vuelta
+// del bucle de eventos; después state() las da por fallidas.
+class BuildScheduler : public QObject {
+    Q_OBJECT
+public:
+    enum State { Queued, Running, Succeeded, Failed, Cancelled };
+
+    struct Job {
+        QString key;                      // "build", "run", "test"...
+        QString title;                    // para los mensajes
+        QString pane;                     // panel de salida; vacío en las de fondo
+        QString resource;
+        QString program;
+        QStringList arguments;
+        QString workingDirectory;
+        QByteArray input;                 // se escribe en stdin, que luego se cierra
+        QProcessEnvironment environment;  // vacío: el del IDE
+        QList<int> dependencies;
+        // Si devuelve false la tarea se da por buena sin lanzarse
+        std::function<bool()> condition;
+        std::function<void()> onSuccess;
+    };
+
+    explicit BuildScheduler(QObject *parent = nullptr);
+    ~BuildScheduler() override;
+
+    int submit(const Job &job);
+    void cancel(int id);
+    void cancelAll();
+
+    State state(int id) const;
+    const Job *job(int id) const;
+    bool isBusy() const;
+
+    static constexpr int MAX_PARALLEL = 4;
+
+signals:
+    // También para las que luego se saltan por su condición
+    void jobStarted(int id);
+    void jobOutput(int id, const QByteArray &bytes);
+    // 'skipped': la condición dijo que no hacía falta lanzarla
+    void jobFinished(int id, BuildScheduler::State state, qint64 elapsedMs, bool skipped);
+
+private:
+    struct Entry {
+        Job job;
+        State state = Queued;
+        QProcess *process = nullptr;
+        QElapsedTimer timer;
+        bool cancelRequested = false;
+    };
+
+    void schedule();
+    void start(int id);
+    void finish(int id, State state, bool skipped = false);
+    void prune();
+    bool resourceBusy(const QString &resource) const;
+
+    QHash<int, Entry> m_entries;
+    QList<int> m_order;               // orden de llegada de las tareas en cola
+    int m_nextId = 1;
+    int m_running = 0;
+    bool m_scheduling = false;
+    bool m_prunePending = false;
+};
@@ -0,0 +1,128 @@
+#include "BuildTimeline.h"
+
+#include <QFileInfo>
+#include <QHelpEvent>
+#include <QPainter>
+#include <QToolTip>
+
+BuildTimeline::BuildTimeline(QWidget *parent)
+    : QWidget(parent) {
+    setMouseTracking(true);
+}
+
+void BuildTimeline::setAnalysis(const NinjaBuildAnalysis &analysis) {
+    m_analysis = analysis;
+    setMinimumHeight(sizeHint().height());
+    updateGeometry();
+    update();
+}
+
+QSize BuildTimeline::sizeHint() const {
+    return QSize(600, SUMMARY_HEIGHT + GRAPH_HEIGHT + m_analysis.lanes * LANE_HEIGHT + 8);
+}
+
+QString BuildTimeline::summary() const {
+    const NinjaBuildAnalysis &a = m_analysis;
+    if (a.upToDate) return tr("Nada recompilado: todo estaba al día");
+    if (a.isEmpty()) return tr("Sin datos de Ninja para la última compilación");
+    QStringList serial;
+    for (int i = 0; i < qMin(3, int(a.serializing.size())); ++i) {
+        const NinjaEdge &e = a.edges[a.serializing[i]];
+        serial << tr("%1 (%2 s)").arg(QFileInfo(e.output).fileName()).arg(e.serialMs / 1000.0, 0, 'f', 1);
+    }
+    const QString critical = a.criticalPath.isEmpty()
+            ? tr("Sin el grafo de ninja no se calcula el camino crítico.")
+            : tr("Camino crítico: %1 s en %2 aristas (con núcleos ilimitados no bajaría de ahí).")
+                  .arg(a.criticalMs / 1000.0, 0, 'f', 1).arg(a.criticalPath.size());
+    return tr("%1 aristas en %2 s, paralelismo medio %3. %4\nSerializan: %5")
+            .arg(a.edges.size()).arg(a.wallMs / 1000.0, 0, 'f', 1)
+            .arg(a.averageParallelism(), 0, 'f', 1)
+            .arg(critical)
+            .arg(serial.isEmpty() ? tr("nada") : serial.join(QStringLiteral(", ")));
+}
+
+// ---------- Geometría ----------
+
+qint64 BuildTimeline::originMs() const {
+    return m_analysis.isEmpty() ? 0 : m_analysis.edges.first().startMs;
+}
+
+double BuildTimeline::pixelsPerMs() const {
+    return m_analysis.wallMs > 0 ? double(width() - 8) / m_analysis.wallMs : 0.0;
+}
+
+int BuildTimeline::edgeAt(const QPoint &pos) const {
+    const int top = SUMMARY_HEIGHT + GRAPH_HEIGHT;
+    if (pos.y() < top) return -1;
+    const int lane = (pos.y() - top) / LANE_HEIGHT;
+    const double scale = pixelsPerMs();
+    if (scale <= 0) return -1;
+    const qint64 time = originMs() + qint64((pos.x() - 4) / scale);
+    for (int i = 0; i < m_analysis.edges.size(); ++i) {
+        const NinjaEdge &e = m_analysis.edges[i];
+        if (e.lane == lane && e.startMs <= time && time <= e.endMs) return i;
+    }
+    return -1;
+}
+
+// ---------- Pintado ----------
+
+void BuildTimeline::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(18, 28, 48));
+    painter.setPen(QColor(220, 230, 245));
+    painter.drawText(QRect(4, 2, width() - 8, SUMMARY_HEIGHT - 4), Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap, summary());
+    const NinjaBuildAnalysis &a = m_analysis;
+    if (a.isEmpty()) return;
+
+    const double scale = pixelsPerMs();
+    const qint64 origin = originMs();
+    auto x = [&](qint64 ms) { return 4 + int((ms - origin) * scale); };
+
+    // Paralelismo: escalones de altura proporcional a las aristas corriendo
+    const int graphBottom = SUMMARY_HEIGHT + GRAPH_HEIGHT - 4;
+    const double unit = double(GRAPH_HEIGHT - 8) / qMax(1, a.lanes);
+    for (int i = 0; i + 1 < a.parallelism.size(); ++i) {
+        const int running = a.parallelism[i].second;
+        if (running == 0) continue;
+        const int left = x(a.parallelism[i].first);
+        const int right = qMax(left + 1, x(a.parallelism[i + 1].first));
+        const int h = qMax(1, int(running * unit));
+        painter.fillRect(QRect(left, graphBottom - h, right - left, h),
+                         running == 1 ? QColor("#E5C07B") : QColor("#61AFEF"));
+    }
+
+    // Aristas
+    const int top = SUMMARY_HEIGHT + GRAPH_HEIGHT;
+    for (const NinjaEdge &e : a.edges) {
+        const QRect r(x(e.startMs), top + e.lane * LANE_HEIGHT + 1, qMax(1, x(e.endMs) - x(e.startMs)), LANE_HEIGHT - 2);
+        painter.fillRect(r, e.critical ? QColor("#E06C75") : QColor(30, 90, 170));
+        if (r.width() > 40) {
+            painter.setPen(QColor(250, 250, 255));
+            painter.drawText(r.adjusted(2, 0, -2, 0), Qt::AlignLeft | Qt::AlignVCenter,
+                             painter.fontMetrics().elidedText(QFileInfo(e.output).fileName(), Qt::ElideRight, r.width() - 4));
+        }
+    }
+}
+
+bool BuildTimeline::event(QEvent *event) {
+    if (event->type() == QEvent::ToolTip) {
+        auto help = static_cast<QHelpEvent *>(event);
+        const int index = edgeAt(help->pos());
+        if (index < 0) {
+            QToolTip::hideText();
+        } else {
+            const NinjaEdge &e = m_analysis.edges[index];
+            QString text = tr("%1\n%2 s (de %3 s a %4 s)").arg(e.output)
+                    .arg(e.duration() / 1000.0, 0, 'f', 2)
+                    .arg((e.startMs - originMs()) / 1000.0, 0, 'f', 2)
+                    .arg((e.endMs - originMs()) / 1000.0, 0, 'f', 2);
+            if (e.outputs.size() > 1) text += tr("\n%1 ficheros de salida").arg(e.outputs.size());
+            if (e.serialMs > 0) text += tr("\nSola durante %1 s").arg(e.serialMs / 1000.0, 0, 'f', 2);
+            if (e.critical) text += tr("\nEn el camino crítico");
+            QToolTip::showText(help->globalPos(), text, this);
+        }
+        return true;
+    }
+    return QWidget::event(event);
+}
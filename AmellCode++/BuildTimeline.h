@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QWidget>
+
+#include "NinjaLog.h"
+
+// Cronología de la última compilación con Ninja: arriba el número de
+// aristas en paralelo a lo largo del tiempo y debajo una fila por hueco de
+// ejecución. El camino crítico (según el grafo de ninja) va en rojo; el
+// resumen dice cuánto duraría la compilación con núcleos ilimitados y qué
+// aristas la serializan.
+class BuildTimeline : public QWidget {
+    Q_OBJECT
+public:
+    explicit BuildTimeline(QWidget *parent = nullptr);
+
+    void setAnalysis(const NinjaBuildAnalysis &analysis);
+    QString summary() const;
+
+    QSize sizeHint() const override;
+
+    static constexpr int SUMMARY_HEIGHT = 56;
+    static constexpr int GRAPH_HEIGHT = 48;
+    static constexpr int LANE_HEIGHT = 14;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    double pixelsPerMs() const;
+    qint64 originMs() const;
+    int edgeAt(const QPoint &pos) const;
+
+    NinjaBuildAnalysis m_analysis;
+};
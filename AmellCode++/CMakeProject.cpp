@@ -0,0 +1,258 @@
+#include "CMakeProject.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcessEnvironment>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <algorithm>
+
+namespace {
+
+// Entradas de la configuración; no se baja a directorios ocultos ni a
+// directorios de compilación (los que tienen CMakeCache.txt). 'dirs' recibe
+// los directorios recorridos: un fichero nuevo en cualquiera puede contar
+void collectInputs(const QDir &dir, const QString &buildDir, QFileInfoList &out, QStringList &dirs) {
+    static const QStringList names = {"CMakeLists.txt", "*.cmake", "CMakePresets.json", "CMakeUserPresets.json"};
+    dirs << dir.absolutePath();
+    out += dir.entryInfoList(names, QDir::Files);
+    for (const QFileInfo &sub : dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        const QString path = sub.absoluteFilePath();
+        if (path == buildDir || QFileInfo::exists(path + "/CMakeCache.txt")) continue;
+        collectInputs(QDir(path), buildDir, out, dirs);
+    }
+}
+
+QString inputEntry(const QFileInfo &info) {
+    return QStringLiteral("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.size())
+            .arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+QJsonObject readJson(const QString &path) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return QJsonObject();
+    return QJsonDocument::fromJson(f.readAll()).object();
+}
+
+// Las rutas de la respuesta son relativas al directorio de fuentes o al de
+// compilación salvo que ya vengan absolutas
+QString absolute(const QString &path, const QString &base) {
+    return QDir::cleanPath(QDir(base).absoluteFilePath(path));
+}
+
+} // namespace
+
+CMakeProject::CMakeProject(const QString &sourceDir, const QString &buildDir)
+    : m_sourceDir(QDir(sourceDir).absolutePath()),
+      m_buildDir(QDir(buildDir).absolutePath()),
+      m_inputWatcher(std::make_unique<QFileSystemWatcher>()) {
+    const auto invalidate = [this]() { m_inputsValid = false; };
+    QObject::connect(m_inputWatcher.get(), &QFileSystemWatcher::fileChanged, invalidate);
+    QObject::connect(m_inputWatcher.get(), &QFileSystemWatcher::directoryChanged, invalidate);
+}
+
+CMakeProject::~CMakeProject() = default;
+
+// Valor de una entrada de CMakeCache.txt ("NOMBRE:TIPO=valor")
+QString CMakeProject::cachedValue(const QByteArray &name) const {
+    QFile f(m_buildDir + "/CMakeCache.txt");
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return QString();
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine().trimmed();
+        if (!line.startsWith(name + ':')) continue;
+        const qsizetype eq = line.indexOf('=');
+        if (eq > 0) return QString::fromUtf8(line.mid(eq + 1));
+    }
+    return QString();
+}
+
+QString CMakeProject::generator() const {
+    const QString cached = cachedValue("CMAKE_GENERATOR");
+    if (!cached.isEmpty()) return cached;
+    return QStandardPaths::findExecutable("ninja").isEmpty() ? QString() : QStringLiteral("Ninja");
+}
+
+QString CMakeProject::makeProgram() const {
+    const QString cached = cachedValue("CMAKE_MAKE_PROGRAM");
+    return cached.isEmpty() ? QStringLiteral("ninja") : cached;
+}
+
+QStringList CMakeProject::configureArguments() const {
+    QStringList args{"-S", m_sourceDir, "-B", m_buildDir, "-DCMAKE_EXPORT_COMPILE_COMMANDS=ON"};
+    const QString gen = generator();
+    if (!gen.isEmpty() && cachedValue("CMAKE_GENERATOR").isEmpty()) args << "-G" << gen;
+    // Sin lanzador solo se borra el que pusimos nosotros, no un ccache del usuario
+    const QString launcher = m_launcher.join(QLatin1Char(';'));
+    for (const char *lang : {"C", "CXX"}) {
+        const QByteArray var = QByteArray("CMAKE_") + lang + "_COMPILER_LAUNCHER";
+        if (!launcher.isEmpty() || cachedValue(var).contains(QLatin1String("--compile-cache")))
+            args << QStringLiteral("-D%1=%2").arg(QString::fromLatin1(var), launcher);
+    }
+    if (m_timeTrace)
+        args << QStringLiteral("-DCMAKE_PROJECT_INCLUDE=%1").arg(timeTraceScriptPath());
+    else if (cachedValue("CMAKE_PROJECT_INCLUDE") == timeTraceScriptPath())
+        args << QStringLiteral("-DCMAKE_PROJECT_INCLUDE=");
+    return args;
+}
+
+QStringList CMakeProject::buildArguments(const QString &target) const {
+    QStringList args{"--build", m_buildDir, "--parallel", QString::number(QThread::idealThreadCount())};
+    if (!target.isEmpty()) args << "--target" << target;
+    return args;
+}
+
+QString CMakeProject::timeTraceScriptPath() const {
+    return m_buildDir + "/.amellide/timetrace.cmake";
+}
+
+void CMakeProject::setTimeTrace(bool enabled) {
+    m_timeTrace = enabled;
+    if (!enabled) return;
+    const QByteArray script =
+            "# Generado por AmellIDE: perfil de tiempos de compilación\n"
+            "if(CMAKE_CXX_COMPILER_ID MATCHES \"Clang\" OR CMAKE_C_COMPILER_ID MATCHES \"Clang\")\n"
+            "  add_compile_options(-ftime-trace)\n"
+            "elseif(CMAKE_CXX_COMPILER_ID STREQUAL \"GNU\" OR CMAKE_C_COMPILER_ID STREQUAL \"GNU\")\n"
+            "  add_compile_options(-ftime-report)\n"
+            "endif()\n";
+    // Reescribirlo sin cambios haría que CMake se regenerase en cada compilación
+    QFile f(timeTraceScriptPath());
+    if (f.open(QIODevice::ReadOnly) && f.readAll() == script) return;
+    f.close();
+    QDir().mkpath(QFileInfo(timeTraceScriptPath()).absolutePath());
+    if (f.open(QIODevice::WriteOnly | QIODevice::Truncate)) f.write(script);
+}
+
+// ---------- Huella de la configuración ----------
+
+QString CMakeProject::fingerprintPath() const {
+    return m_buildDir + "/.amellide/configure.sha1";
+}
+
+// Recorrer el árbol en cada Ctrl+B bloquearía la interfaz en proyectos
+// grandes: se recorre una vez y se vuelve a hacer solo si el watcher avisa
+const QStringList &CMakeProject::inputEntries() const {
+    if (m_inputsValid) return m_inputEntries;
+    QFileInfoList inputs;
+    QStringList dirs;
+    collectInputs(QDir(m_sourceDir), m_buildDir, inputs, dirs);
+
+    m_inputEntries.clear();
+    QStringList files;
+    for (const QFileInfo &info : std::as_const(inputs)) {
+        m_inputEntries << inputEntry(info);
+        files << info.absoluteFilePath();
+    }
+    m_inputEntries.sort();
+
+    const QStringList watched = m_inputWatcher->files() + m_inputWatcher->directories();
+    if (!watched.isEmpty()) m_inputWatcher->removePaths(watched);
+    m_inputWatcher->addPaths(dirs + files);
+    m_inputsValid = true;
+    return m_inputEntries;
+}
+
+QByteArray CMakeProject::fingerprint() const {
+    QStringList entries = inputEntries();
+    // El toolchain puede estar fuera del árbol: se consulta cada vez
+    const QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    const QString toolchain = env.value("CMAKE_TOOLCHAIN_FILE");
+    if (!toolchain.isEmpty()) entries << inputEntry(QFileInfo(toolchain));
+    for (const char *var : {"CC", "CXX", "CFLAGS", "CXXFLAGS", "LDFLAGS", "CMAKE_GENERATOR", "CMAKE_BUILD_TYPE"})
+        entries << QStringLiteral("%1=%2").arg(QLatin1String(var), env.value(QLatin1String(var)));
+    entries << m_sourceDir << m_buildDir << generator() << m_launcher.join(QLatin1Char(';'))
+            << (m_timeTrace ? QStringLiteral("time-trace") : QString());
+    entries << QStandardPaths::findExecutable("cmake");
+
+    return QCryptographicHash::hash(entries.join(QLatin1Char('\n')).toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+// Sin respuesta de la File API no hay objetivos ni, sin compile_commands.json,
+// opciones por fichero: en ambos casos también hace falta configurar
+bool CMakeProject::needsConfigure() const {
+    if (!QFileInfo::exists(m_buildDir + "/CMakeCache.txt")) return true;
+    if (replyIndexPath().isEmpty()) return true;
+    // Solo Ninja y Makefiles generan compile_commands.json
+    const QString gen = generator();
+    if ((gen.contains(QLatin1String("Ninja")) || gen.contains(QLatin1String("Makefiles")))
+            && !QFileInfo::exists(m_buildDir + "/compile_commands.json"))
+        return true;
+    QFile f(fingerprintPath());
+    if (!f.open(QIODevice::ReadOnly)) return true;
+    return f.readAll().trimmed() != fingerprint();
+}
+
+void CMakeProject::markConfigured() {
+    QDir().mkpath(QFileInfo(fingerprintPath()).absolutePath());
+    QFile f(fingerprintPath());
+    if (f.open(QIODevice::WriteOnly | QIODevice::Truncate)) f.write(fingerprint());
+}
+
+// ---------- File API ----------
+
+void CMakeProject::writeFileApiQuery() const {
+    const QString dir = m_buildDir + "/.cmake/api/v1/query/client-amellide";
+    const QString query = dir + "/codemodel-v2";
+    if (QFileInfo::exists(query)) return;
+    QDir().mkpath(dir);
+    QFile f(query);
+    f.open(QIODevice::WriteOnly);
+}
+
+// CMake nombra los índices con la fecha: el mayor es el último
+QString CMakeProject::replyIndexPath() const {
+    const QDir reply(m_buildDir + "/.cmake/api/v1/reply");
+    const QStringList indexes = reply.entryList({"index-*.json"}, QDir::Files, QDir::Name);
+    return indexes.isEmpty() ? QString() : reply.absoluteFilePath(indexes.last());
+}
+
+QVector<CMakeTarget> CMakeProject::readCodeModel(const QString &replyIndexPath,
+                                                 const QString &sourceDir, const QString &buildDir) {
+    QVector<CMakeTarget> targets;
+    const QString replyDir = QFileInfo(replyIndexPath).absolutePath();
+    QString codeModelFile;
+    for (const QJsonValue &object : readJson(replyIndexPath).value("objects").toArray()) {
+        if (object.toObject().value("kind").toString() == QLatin1String("codemodel"))
+            codeModelFile = object.toObject().value("jsonFile").toString();
+    }
+    if (codeModelFile.isEmpty()) return targets;
+
+    // Con generadores multiconfiguración se toma la primera
+    const QJsonArray configurations = readJson(replyDir + "/" + codeModelFile).value("configurations").toArray();
+    if (configurations.isEmpty()) return targets;
+    for (const QJsonValue &ref : configurations.first().toObject().value("targets").toArray()) {
+        const QJsonObject json = readJson(replyDir + "/" + ref.toObject().value("jsonFile").toString());
+        CMakeTarget target;
+        target.name = json.value("name").toString();
+        target.type = json.value("type").toString();
+        for (const QJsonValue &artifact : json.value("artifacts").toArray())
+            target.artifacts << absolute(artifact.toObject().value("path").toString(), buildDir);
+        for (const QJsonValue &source : json.value("sources").toArray())
+            target.sources << absolute(source.toObject().value("path").toString(), sourceDir);
+        if (!target.name.isEmpty()) targets.append(target);
+    }
+    std::sort(targets.begin(), targets.end(), [](const CMakeTarget &a, const CMakeTarget &b) {
+        return a.name < b.name;
+    });
+    return targets;
+}
+
+void CMakeProject::setCodeModel(const QString &replyIndexPath, const QVector<CMakeTarget> &targets) {
+    m_codeModelIndex = replyIndexPath;
+    m_targets = targets;
+}
+
+const CMakeTarget *CMakeProject::target(const QString &name) const {
+    for (const CMakeTarget &t : m_targets) {
+        if (t.name == name) return &t;
+    }
+    return nullptr;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+
+class QFileSystemWatcher;
+
+// Objetivo del modelo de código de CMake (File API, codemodel-v2)
+struct CMakeTarget {
+    QString name;
+    QString type;                     // EXECUTABLE, STATIC_LIBRARY, UTILITY...
+    QStringList artifacts;            // rutas absolutas de lo que produce
+    QStringList sources;              // rutas absolutas
+
+    bool isExecutable() const { return type == QLatin1String("EXECUTABLE"); }
+};
+
+// Proyecto CMake abierto en el IDE: sabe qué argumentos usar para
+// configurar y compilar y si hace falta volver a configurar.
+//
+// La configuración depende de los CMakeLists.txt, los *.cmake, los presets,
+// el toolchain, los compiladores del entorno y los propios argumentos. Se
+// guarda una huella (ruta, tamaño y fecha de cada fichero más el resto) en
+// el directorio de compilación y solo se reconfigura cuando cambia o falta
+// CMakeCache.txt, así que un Ctrl+B sobre un árbol al día va directo a
+// "cmake --build". La lista de entradas se recorre una vez y queda en
+// caché; un QFileSystemWatcher sobre esos ficheros y sus directorios la
+// invalida cuando algo cambia, así que normalmente no se toca el disco.
+//
+// Los objetivos salen de la File API: antes de configurar se deja la
+// consulta codemodel-v2 en el directorio de compilación y CMake escribe la
+// respuesta en cada configure. Esa respuesta es la caché: solo se vuelve a
+// leer cuando cambia su índice.
+class CMakeProject {
+public:
+    CMakeProject(const QString &sourceDir, const QString &buildDir);
+    ~CMakeProject();
+
+    const QString &sourceDir() const { return m_sourceDir; }
+    const QString &buildDir() const { return m_buildDir; }
+
+    bool needsConfigure() const;
+    // Tras un configure correcto
+    void markConfigured();
+
+    QStringList configureArguments() const;
+    // Con 'target' solo se compila ese objetivo y sus dependencias
+    QStringList buildArguments(const QString &target = QString()) const;
+
+    // ---------- File API ----------
+    void writeFileApiQuery() const;
+    // Índice de la última respuesta o vacío si aún no hay
+    QString replyIndexPath() const;
+    // Lee la respuesta; se puede llamar desde cualquier hilo
+    static QVector<CMakeTarget> readCodeModel(const QString &replyIndexPath,
+                                              const QString &sourceDir, const QString &buildDir);
+
+    const QVector<CMakeTarget> &targets() const { return m_targets; }
+    const QString &codeModelIndex() const { return m_codeModelIndex; }
+    void setCodeModel(const QString &replyIndexPath, const QVector<CMakeTarget> &targets);
+    const CMakeTarget *target(const QString &name) const;
+
+    // Ninja si está instalado, salvo que el directorio ya use otro generador
+    QString generator() const;
+    // El make o ninja que usa el directorio de compilación
+    QString makeProgram() const;
+
+    // CMAKE_<LANG>_COMPILER_LAUNCHER para C y C++; vacío para quitarlo
+    void setCompilerLauncher(const QStringList &launcher) { m_launcher = launcher; }
+    // Modo perfil: -ftime-trace con Clang, -ftime-report con GCC, a través
+    // de un CMAKE_PROJECT_INCLUDE que elige según el compilador detectado
+    void setTimeTrace(bool enabled);
+    bool timeTrace() const { return m_timeTrace; }
+
+private:
+    QByteArray fingerprint() const;
+    // "ruta|tamaño|fecha" de cada entrada del árbol de fuentes, ordenadas
+    const QStringList &inputEntries() const;
+    QString fingerprintPath() const;
+    QString cachedValue(const QByteArray &name) const;
+    QString timeTraceScriptPath() const;
+
+    QString m_sourceDir;
+    QString m_buildDir;
+    QStringList m_launcher;
+    bool m_timeTrace = false;
+    QString m_codeModelIndex;         // índice del que salen m_targets
+    QVector<CMakeTarget> m_targets;
+
+    std::unique_ptr<QFileSystemWatcher> m_inputWatcher;
+    mutable QStringList m_inputEntries;
+    mutable bool m_inputsValid = false;
+};
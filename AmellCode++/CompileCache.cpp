@@ -0,0 +1,254 @@
+#include "CompileCache.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+// Lo que importa de una línea "compilador -c fuente -o objeto"
+struct Invocation {
+    QString source;
+    QString output;
+    QString depFile;                  // vacío si no se pide
+    QStringList preprocessArgs;       // sin salida ni dependencias, con -E
+};
+
+bool isSource(const QString &arg) {
+    static const QStringList suffixes = {"c", "cc", "cpp", "cxx", "c++", "C", "m", "mm"};
+    return !arg.startsWith(QLatin1Char('-')) && suffixes.contains(QFileInfo(arg).suffix());
+}
+
+// false si no es una compilación simple de una unidad a un objeto: enlazar,
+// preprocesar, respuestas @fichero o lo que deje ficheros adicionales
+bool analyze(const QStringList &args, Invocation *inv) {
+    static const QStringList unsupported = {"-E", "-S", "-M", "-MM", "-save-temps", "--coverage",
+                                            "-ftest-coverage", "-fprofile-arcs", "-gsplit-dwarf",
+                                            "-ftime-trace", "-ftime-report", "-"};
+    static const QStringList depWithValue = {"-MF", "-MT", "-MQ"};
+    bool compileOnly = false;
+    bool wantsDeps = false;
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &arg = args[i];
+        if (unsupported.contains(arg) || arg.startsWith(QLatin1Char('@'))) return false;
+        if (arg == QLatin1String("-c")) {
+            compileOnly = true;
+        } else if (arg == QLatin1String("-o") && i + 1 < args.size()) {
+            inv->output = args[++i];
+        } else if (depWithValue.contains(arg) && i + 1 < args.size()) {
+            if (arg == QLatin1String("-MF")) inv->depFile = args[i + 1];
+            ++i;
+        } else if (arg == QLatin1String("-MD") || arg == QLatin1String("-MMD")) {
+            wantsDeps = true;
+        } else if (arg == QLatin1String("-MP")) {
+            // Solo afecta al fichero de dependencias
+        } else if (isSource(arg)) {
+            if (!inv->source.isEmpty()) return false;
+            inv->source = arg;
+            inv->preprocessArgs << arg;
+        } else {
+            inv->preprocessArgs << arg;
+        }
+    }
+    if (!compileOnly || inv->source.isEmpty() || inv->output.isEmpty()) return false;
+    // -MD sin -MF: GCC y Clang lo dejan junto al objeto
+    if (wantsDeps && inv->depFile.isEmpty()) {
+        const QFileInfo out(inv->output);
+        inv->depFile = out.path() + QLatin1Char('/') + out.completeBaseName() + QStringLiteral(".d");
+    }
+    if (!wantsDeps) inv->depFile.clear();
+    inv->preprocessArgs << "-E";
+    return true;
+}
+
+void recordStat(char kind) {
+    const QString path = qEnvironmentVariable(CompileCache::STATS_ENV);
+    if (path.isEmpty()) return;
+    // Escrituras de un byte en modo append: las invocaciones paralelas no se pisan
+    QFile f(path);
+    if (f.open(QIODevice::WriteOnly | QIODevice::Append)) f.write(&kind, 1);
+}
+
+int passthrough(const QString &compiler, const QStringList &args) {
+    QProcess process;
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(compiler, args);
+    if (!process.waitForStarted(-1)) {
+        std::fprintf(stderr, "amell-cache: no se pudo lanzar %s\n", qPrintable(compiler));
+        return 127;
+    }
+    process.waitForFinished(-1);
+    return process.exitStatus() == QProcess::NormalExit ? process.exitCode() : 1;
+}
+
+// Ruta, tamaño y fecha del ejecutable: actualizar el compilador invalida la caché
+QByteArray compilerIdentity(const QString &compiler) {
+    QString path = compiler;
+    if (!QFileInfo(path).isAbsolute()) path = QStandardPaths::findExecutable(compiler);
+    const QFileInfo info(QFileInfo(path).canonicalFilePath());
+    return QStringLiteral("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.size())
+            .arg(info.lastModified().toMSecsSinceEpoch()).toUtf8();
+}
+
+bool copyReplacing(const QString &from, const QString &to) {
+    QFile::remove(to);
+    return QFile::copy(from, to);
+}
+
+// Se copia con otro nombre y se renombra: otro proceso nunca ve una entrada a medias
+bool storeFile(const QString &from, const QString &to) {
+    const QString tmp = to + QStringLiteral(".tmp%1").arg(QCoreApplication::applicationPid());
+    if (!copyReplacing(from, tmp)) return false;
+    QFile::remove(to);
+    return QFile::rename(tmp, to);
+}
+
+bool storeBytes(const QByteArray &bytes, const QString &to) {
+    QSaveFile f(to);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+    f.write(bytes);
+    return f.commit();
+}
+
+QByteArray readAll(const QString &path) {
+    QFile f(path);
+    return f.open(QIODevice::ReadOnly) ? f.readAll() : QByteArray();
+}
+
+} // namespace
+
+QString CompileCache::directory() {
+    const QString configured = QSettings().value(QStringLiteral("build/compileCacheDir")).toString();
+    if (!configured.isEmpty()) return configured;
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/compile-cache");
+}
+
+qint64 CompileCache::maxBytes() {
+    return QSettings().value(QStringLiteral("build/compileCacheMaxMB"), DEFAULT_MAX_MB).toLongLong() * 1024 * 1024;
+}
+
+// ---------- Lanzador ----------
+
+int CompileCache::runLauncher(const QStringList &command) {
+    if (command.isEmpty()) return 2;
+    const QString compiler = command.first();
+    const QStringList args = command.mid(1);
+
+    Invocation inv;
+    if (!analyze(args, &inv)) {
+        recordStat('U');
+        return passthrough(compiler, args);
+    }
+
+    QProcess preprocess;
+    preprocess.setStandardErrorFile(QProcess::nullDevice());
+    preprocess.start(compiler, inv.preprocessArgs);
+    if (!preprocess.waitForFinished(-1) || preprocess.exitStatus() != QProcess::NormalExit
+            || preprocess.exitCode() != 0) {
+        // Que el compilador dé el error de verdad
+        recordStat('U');
+        return passthrough(compiler, args);
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(QByteArrayLiteral("amell-cache-1\n"));
+    hash.addData(compilerIdentity(compiler));
+    hash.addData(QDir::currentPath().toUtf8());
+    for (const QString &arg : args) {
+        hash.addData(QByteArrayView("\0", 1));
+        hash.addData(arg.toUtf8());
+    }
+    hash.addData(preprocess.readAllStandardOutput());
+    const QString key = QString::fromLatin1(hash.result().toHex());
+
+    const QString dir = directory() + QLatin1Char('/') + key.left(2);
+    const QString entry = dir + QLatin1Char('/') + key.mid(2);
+    const QString object = entry + QStringLiteral(".o");
+
+    // ---------- Acierto ----------
+    if (QFileInfo::exists(object) && copyReplacing(object, inv.output)
+            && (inv.depFile.isEmpty() || copyReplacing(entry + QStringLiteral(".d"), inv.depFile))) {
+        const QByteArray diagnostics = readAll(entry + QStringLiteral(".stderr"));
+        std::fwrite(diagnostics.constData(), 1, size_t(diagnostics.size()), stderr);
+        // La fecha de la entrada es la de su último uso
+        QFile touched(object);
+        if (touched.open(QIODevice::ReadWrite))
+            touched.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        recordStat('H');
+        return 0;
+    }
+
+    // ---------- Fallo: se compila y se guarda ----------
+    QProcess compile;
+    compile.setProcessChannelMode(QProcess::ForwardedOutputChannel);
+    compile.start(compiler, args);
+    if (!compile.waitForStarted(-1)) {
+        std::fprintf(stderr, "amell-cache: no se pudo lanzar %s\n", qPrintable(compiler));
+        return 127;
+    }
+    compile.waitForFinished(-1);
+    const QByteArray diagnostics = compile.readAllStandardError();
+    std::fwrite(diagnostics.constData(), 1, size_t(diagnostics.size()), stderr);
+    recordStat('M');
+    if (compile.exitStatus() != QProcess::NormalExit || compile.exitCode() != 0)
+        return compile.exitStatus() == QProcess::NormalExit ? compile.exitCode() : 1;
+
+    // El objeto va el último: su presencia marca la entrada como completa
+    QDir().mkpath(dir);
+    if (storeBytes(diagnostics, entry + QStringLiteral(".stderr"))
+            && (inv.depFile.isEmpty() || storeFile(inv.depFile, entry + QStringLiteral(".d"))))
+        storeFile(inv.output, object);
+    return 0;
+}
+
+// ---------- Mantenimiento ----------
+
+void CompileCache::evict(const QString &directory, qint64 maxBytes) {
+    struct Item {
+        QString base;
+        qint64 bytes;
+        qint64 used;
+    };
+    QVector<Item> items;
+    qint64 total = 0;
+    QDirIterator it(directory, {"*.o"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QString base = info.absolutePath() + QLatin1Char('/') + info.completeBaseName();
+        const qint64 bytes = info.size() + QFileInfo(base + ".d").size() + QFileInfo(base + ".stderr").size();
+        items.append({base, bytes, info.lastModified().toMSecsSinceEpoch()});
+        total += bytes;
+    }
+    if (total <= maxBytes) return;
+
+    std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) { return a.used < b.used; });
+    for (const Item &item : std::as_const(items)) {
+        if (total <= maxBytes) break;
+        QFile::remove(item.base + ".o");
+        QFile::remove(item.base + ".d");
+        QFile::remove(item.base + ".stderr");
+        total -= item.bytes;
+    }
+}
+
+CompileCache::Stats CompileCache::readStats(const QString &statsPath) {
+    Stats stats;
+    for (char c : readAll(statsPath)) {
+        if (c == 'H') ++stats.hits;
+        else if (c == 'M') ++stats.misses;
+        else if (c == 'U') ++stats.uncacheable;
+    }
+    return stats;
+}
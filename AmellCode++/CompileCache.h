@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+// Caché local de compilaciones, al estilo de ccache. El propio ejecutable
+// del IDE hace de CMAKE_<LANG>_COMPILER_LAUNCHER ("AmellIDE --compile-cache
+// g++ ..."): preprocesa la unidad y calcula un SHA-256 del resultado, las
+// opciones y la identidad del compilador. Si el objeto ya está en el
+// almacén se copia (con su fichero de dependencias y sus advertencias) sin
+// llamar al compilador; si no, se compila y se guarda.
+//
+// El almacén es direccionable por contenido y se recorta por antigüedad de
+// uso (LRU) tras cada compilación. Cada invocación anota su resultado en el
+// fichero de STATS_ENV para el resumen de aciertos y fallos.
+class CompileCache {
+public:
+    struct Stats {
+        int hits = 0;
+        int misses = 0;
+        int uncacheable = 0;
+
+        int total() const { return hits + misses + uncacheable; }
+    };
+
+    // 'command' empieza por el compilador; devuelve su código de salida
+    static int runLauncher(const QStringList &command);
+
+    static QString directory();
+    static qint64 maxBytes();
+    // Borra las entradas menos usadas hasta quedar por debajo de 'maxBytes'
+    static void evict(const QString &directory, qint64 maxBytes);
+
+    static Stats readStats(const QString &statsPath);
+
+    static constexpr const char *LAUNCHER_FLAG = "--compile-cache";
+    static constexpr const char *STATS_ENV = "AMELL_COMPILE_CACHE_STATS";
+    static constexpr int DEFAULT_MAX_MB = 5 * 1024;
+};
@@ -0,0 +1,346 @@
+#include "CompileCommands.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QProcess>
+#include <QThreadPool>
+
+#include <cstring>
+#include <tuple>
+
+namespace {
+
+// ---------- Lector JSON ----------
+// Solo lo necesario para compile_commands.json: un array de objetos con
+// cadenas y arrays de cadenas. Lo demás se salta sin decodificar.
+
+class Scanner {
+public:
+    Scanner(const char *begin, const char *end) : m_p(begin), m_end(end) {}
+
+    const char *position() const { return m_p; }
+    bool atEnd() { skipSpace(); return m_p >= m_end; }
+
+    void skipSpace() {
+        while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) ++m_p;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (m_p >= m_end || *m_p != c) return false;
+        ++m_p;
+        return true;
+    }
+
+    // Devuelve el contenido crudo entre comillas; 'escaped' indica si hay que decodificarlo
+    bool rawString(QByteArrayView *raw, bool *escaped) {
+        if (!consume('"')) return false;
+        const char *start = m_p;
+        *escaped = false;
+        while (m_p < m_end && *m_p != '"') {
+            if (*m_p == '\\') {
+                *escaped = true;
+                ++m_p;
+            }
+            ++m_p;
+        }
+        if (m_p >= m_end) return false;
+        *raw = QByteArrayView(start, m_p - start);
+        ++m_p;
+        return true;
+    }
+
+    bool skipValue() {
+        skipSpace();
+        if (m_p >= m_end) return false;
+        if (*m_p == '"') {
+            QByteArrayView raw;
+            bool escaped;
+            return rawString(&raw, &escaped);
+        }
+        if (*m_p == '{' || *m_p == '[') {
+            // Se cuentan llaves y corchetes fuera de las cadenas
+            int depth = 0;
+            do {
+                if (*m_p == '"') {
+                    QByteArrayView raw;
+                    bool escaped;
+                    if (!rawString(&raw, &escaped)) return false;
+                    continue;
+                }
+                if (*m_p == '{' || *m_p == '[') ++depth;
+                else if (*m_p == '}' || *m_p == ']') --depth;
+                ++m_p;
+            } while (depth > 0 && m_p < m_end);
+            return depth == 0;
+        }
+        while (m_p < m_end && *m_p != ',' && *m_p != '}' && *m_p != ']') ++m_p;
+        return true;
+    }
+
+private:
+    const char *m_p;
+    const char *m_end;
+};
+
+void appendUtf8(QByteArray &out, uint cp) {
+    if (cp < 0x80) {
+        out += char(cp);
+    } else if (cp < 0x800) {
+        out += char(0xC0 | (cp >> 6));
+        out += char(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += char(0xE0 | (cp >> 12));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
+    } else {
+        out += char(0xF0 | (cp >> 18));
+        out += char(0x80 | ((cp >> 12) & 0x3F));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
+    }
+}
+
+QString unescape(QByteArrayView raw) {
+    QByteArray out;
+    out.reserve(raw.size());
+    for (qsizetype i = 0; i < raw.size(); ++i) {
+        const char c = raw[i];
+        if (c != '\\' || i + 1 >= raw.size()) {
+            out += c;
+            continue;
+        }
+        const char e = raw[++i];
+        switch (e) {
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'u': {
+            if (i + 4 >= raw.size()) break;
+            uint cp = QByteArray(raw.data() + i + 1, 4).toUInt(nullptr, 16);
+            i += 4;
+            // Fuera del plano básico llega como par sustituto (dos escapes seguidos)
+            if (cp >= 0xD800 && cp < 0xDC00 && i + 6 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+                const uint low = QByteArray(raw.data() + i + 3, 4).toUInt(nullptr, 16);
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                i += 6;
+            }
+            appendUtf8(out, cp);
+            break;
+        }
+        default: out += e; break;     // \" \\ \/
+        }
+    }
+    return QString::fromUtf8(out);
+}
+
+// Las mismas opciones se repiten en miles de entradas: se decodifican una
+// vez y se comparten
+class Interner {
+public:
+    QString get(QByteArrayView raw, bool escaped) {
+        if (escaped) return unescape(raw);
+        // Sin copiar: la clave apunta a la proyección del fichero
+        const QByteArray key = QByteArray::fromRawData(raw.data(), raw.size());
+        auto it = m_strings.constFind(key);
+        if (it != m_strings.cend()) return *it;
+        const QString s = QString::fromUtf8(raw);
+        m_strings.insert(key, s);
+        return s;
+    }
+
+private:
+    QHash<QByteArray, QString> m_strings;
+};
+
+bool isKey(QByteArrayView key, const char *name) {
+    return key.size() == qsizetype(qstrlen(name)) && memcmp(key.data(), name, key.size()) == 0;
+}
+
+// Fecha y tamaño con los que se compara una lectura; -1/-1 si no existe
+std::pair<qint64, qint64> stampOf(const QString &path) {
+    const QFileInfo info(path);
+    if (!info.exists()) return {-1, -1};
+    return {info.lastModified().toMSecsSinceEpoch(), info.size()};
+}
+
+// Preferencia entre fuentes con el mismo nombre; -1 si no es una fuente
+int sourceRank(QStringView extension) {
+    static const QLatin1String order[] = {QLatin1String("cpp"), QLatin1String("cc"),
+                                          QLatin1String("cxx"), QLatin1String("c")};
+    for (int i = 0; i < 4; ++i) {
+        if (extension == order[i]) return i;
+    }
+    return -1;
+}
+
+QString normalized(const QString &directory, const QString &file) {
+    return QDir::cleanPath(QDir::isAbsolutePath(file) ? file : directory + QLatin1Char('/') + file);
+}
+
+} // namespace
+
+// ---------- Lectura ----------
+
+std::shared_ptr<const CompileCommands::Database>
+CompileCommands::parse(const QString &path, const std::shared_ptr<const Database> &previous, int *reused) {
+    auto db = std::make_shared<Database>();
+    if (reused) *reused = 0;
+    QFile f(path);
+    std::tie(db->modified, db->size) = stampOf(path);
+    if (!f.open(QIODevice::ReadOnly) || f.size() == 0) return db;
+    const uchar *map = f.map(0, f.size());
+    if (!map) return db;
+
+    const char *begin = reinterpret_cast<const char *>(map);
+    Scanner scanner(begin, begin + f.size());
+    Interner interner;
+    if (!scanner.consume('[')) return db;
+
+    db->entries.reserve(previous ? previous->entries.size() : 1024);
+    while (!scanner.atEnd() && !scanner.consume(']')) {
+        scanner.consume(',');
+        scanner.skipSpace();
+        const char *objectStart = scanner.position();
+        if (!scanner.skipValue()) break;
+        const QByteArrayView object(objectStart, scanner.position() - objectStart);
+        // Un resumen fuerte y no qHash: dos entradas distintas con el mismo
+        // qHash harían reutilizar la orden de otro fichero
+        const QByteArray digest = QCryptographicHash::hash(
+            QByteArray::fromRawData(object.data(), object.size()), QCryptographicHash::Sha1);
+
+        // Entrada sin cambios: se reutiliza sin decodificar nada
+        if (previous) {
+            const auto known = previous->fileByDigest.constFind(digest);
+            if (known != previous->fileByDigest.cend()) {
+                const auto entry = previous->entries.constFind(*known);
+                if (entry != previous->entries.cend()) {
+                    db->entries.insert(entry->file, *entry);
+                    db->fileByDigest.insert(digest, entry->file);
+                    if (reused) ++*reused;
+                    continue;
+                }
+            }
+        }
+
+        Scanner fields(object.data(), object.data() + object.size());
+        if (!fields.consume('{')) continue;
+        Entry entry;
+        QString file;
+        QString command;
+        while (!fields.consume('}')) {
+            fields.consume(',');
+            QByteArrayView key;
+            bool escaped;
+            if (!fields.rawString(&key, &escaped) || !fields.consume(':')) break;
+            QByteArrayView raw;
+            if (isKey(key, "arguments")) {
+                if (!fields.consume('[')) break;
+                while (!fields.consume(']')) {
+                    fields.consume(',');
+                    if (!fields.rawString(&raw, &escaped)) break;
+                    entry.arguments << interner.get(raw, escaped);
+                }
+            } else if (isKey(key, "directory") || isKey(key, "file") || isKey(key, "command")) {
+                if (!fields.rawString(&raw, &escaped)) break;
+                const QString value = interner.get(raw, escaped);
+                if (isKey(key, "directory")) entry.directory = value;
+                else if (isKey(key, "file")) file = value;
+                else command = value;
+            } else if (!fields.skipValue()) {
+                break;
+            }
+        }
+        if (entry.arguments.isEmpty() && !command.isEmpty()) entry.arguments = QProcess::splitCommand(command);
+        if (!entry.isValid() || file.isEmpty()) continue;
+        entry.file = normalized(entry.directory, file);
+        db->fileByDigest.insert(digest, entry.file);
+        db->entries.insert(entry.file, entry);
+    }
+
+    // Tablas para las cabeceras, calculadas una vez por lectura
+    QHash<QString, int> stemRank;
+    for (auto it = db->entries.cbegin(); it != db->entries.cend(); ++it) {
+        const QString &file = it.key();
+        const qsizetype slash = file.lastIndexOf(QLatin1Char('/'));
+        const QString dir = file.left(slash);
+        if (!db->byDirectory.contains(dir)) db->byDirectory.insert(dir, file);
+
+        const qsizetype dot = file.lastIndexOf(QLatin1Char('.'));
+        if (dot <= slash) continue;
+        const int rank = sourceRank(QStringView(file).mid(dot + 1));
+        if (rank < 0) continue;
+        const QString stem = file.left(dot);
+        const auto known = stemRank.constFind(stem);
+        if (known != stemRank.cend() && *known <= rank) continue;
+        stemRank.insert(stem, rank);
+        db->byStem.insert(stem, file);
+    }
+    return db;
+}
+
+CompileCommands::CompileCommands(const QString &buildDir, QObject *parent)
+    : QObject(parent),
+      m_buildDir(QDir(buildDir).absolutePath()) {
+}
+
+bool CompileCommands::isStale() const {
+    const auto [modified, size] = stampOf(path());
+    if (!m_database) return size >= 0;
+    return modified != m_database->modified || size != m_database->size;
+}
+
+void CompileCommands::reload() {
+    if (m_loading || !isStale()) return;
+    m_loading = true;
+    const QString file = path();
+    const std::shared_ptr<const Database> previous = m_database;
+    QPointer<CompileCommands> guard(this);
+    QThreadPool::globalInstance()->start([guard, file, previous]() {
+        QElapsedTimer timer;
+        timer.start();
+        int reused = 0;
+        const std::shared_ptr<const Database> db = parse(file, previous, &reused);
+        const qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, db, reused, elapsed]() {
+            if (!guard) return;
+            guard->m_database = db;
+            guard->m_loading = false;
+            emit guard->loaded(int(db->entries.size()), reused, elapsed);
+            // Pudo volver a cambiar mientras se leía; si no, isStale() es
+            // falso (también con el fichero borrado) y no se relee
+            guard->reload();
+        }, Qt::QueuedConnection);
+    });
+}
+
+int CompileCommands::size() const {
+    return m_database ? int(m_database->entries.size()) : 0;
+}
+
+// ---------- Consulta ----------
+
+CompileCommands::Entry CompileCommands::lookup(const QString &filePath) {
+    reload();
+    if (!m_database) return Entry();
+    const QString path = QDir::cleanPath(QFileInfo(filePath).absoluteFilePath());
+    const auto it = m_database->entries.constFind(path);
+    if (it != m_database->entries.cend()) return *it;
+
+    const qsizetype slash = path.lastIndexOf(QLatin1Char('/'));
+    const qsizetype dot = path.lastIndexOf(QLatin1Char('.'));
+    if (dot > slash) {
+        const auto sibling = m_database->byStem.constFind(path.left(dot));
+        if (sibling != m_database->byStem.cend()) return m_database->entries.value(*sibling);
+    }
+    const QString neighbour = m_database->byDirectory.value(path.left(slash));
+    return neighbour.isEmpty() ? Entry() : m_database->entries.value(neighbour);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+// compile_commands.json del directorio de compilación: la orden exacta con
+// la que se compila cada fichero (sintaxis, preprocesado, ensamblador,
+// clangd...).
+//
+// El fichero se proyecta en memoria y se recorre con un lector propio que
+// solo decodifica las claves que interesan, sin construir el árbol JSON; las
+// opciones repetidas entre entradas comparten el mismo QString. La lectura
+// va al pool y sustituye de una vez la tabla anterior, que es inmutable, así
+// que buscar es una consulta a un hash sin bloqueos. Al releer, las entradas
+// cuyo texto no cambió (mismo SHA-1) se reutilizan tal cual.
+class CompileCommands : public QObject {
+    Q_OBJECT
+public:
+    struct Entry {
+        QString directory;
+        QString file;                 // absoluto
+        QStringList arguments;        // compilador incluido
+
+        bool isValid() const { return !arguments.isEmpty(); }
+    };
+
+    struct Database {
+        QHash<QString, Entry> entries;            // fichero absoluto → orden
+        QHash<QString, QString> byStem;           // ruta sin extensión → fuente (.cpp > .cc > .cxx > .c)
+        QHash<QString, QString> byDirectory;      // directorio → una fuente suya
+        QHash<QByteArray, QString> fileByDigest;  // SHA-1 del texto de cada entrada → fichero
+        qint64 modified = -1;
+        qint64 size = -1;
+    };
+
+    // Lee 'path' reutilizando lo que no cambió respecto a 'previous'
+    static std::shared_ptr<const Database> parse(const QString &path,
+                                                 const std::shared_ptr<const Database> &previous,
+                                                 int *reused = nullptr);
+
+    explicit CompileCommands(const QString &buildDir, QObject *parent = nullptr);
+
+    QString path() const { return m_buildDir + "/compile_commands.json"; }
+
+    // Una cabecera usa la orden de la fuente con su mismo nombre o, si no,
+    // la de una fuente de su directorio. Si el fichero cambió en disco se
+    // pide una relectura y mientras tanto se responde con la tabla actual.
+    Entry lookup(const QString &filePath);
+    int size() const;
+
+    // Relee en el pool si cambió desde la última lectura
+    void reload();
+
+signals:
+    void loaded(int entries, int reused, qint64 elapsedMs);
+
+private:
+    bool isStale() const;
+
+    QString m_buildDir;
+    std::shared_ptr<const Database> m_database;
+    bool m_loading = false;
+};
@@ -0,0 +1,139 @@
+#include "CompilerOutputParser.h"
+
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QUrl>
+
+namespace {
+
+QString resolve(const QString &file, const QString &baseDir) {
+    if (file.isEmpty()) return file;
+    return QDir::cleanPath(QDir(baseDir).absoluteFilePath(file));
+}
+
+Diagnostic::Severity severityOf(QStringView kind) {
+    if (kind.contains(QLatin1String("error"))) return Diagnostic::Error;
+    if (kind == QLatin1String("warning")) return Diagnostic::Warning;
+    return Diagnostic::Information;    // note, remark, none
+}
+
+// GCC: [{"kind", "message", "locations": [{"caret": {...}, "finish": {...}}], "children": [...]}]
+void collectGcc(const QJsonArray &items, const QString &baseDir, QVector<Diagnostic> &out) {
+    for (const QJsonValue &value : items) {
+        const QJsonObject item = value.toObject();
+        const QJsonArray locations = item.value("locations").toArray();
+        if (!locations.isEmpty()) {
+            const QJsonObject caret = locations.first().toObject().value("caret").toObject();
+            const QJsonObject finish = locations.first().toObject().value("finish").toObject();
+            Diagnostic d;
+            d.file = resolve(caret.value("file").toString(), baseDir);
+            d.line = caret.value("line").toInt(1) - 1;
+            d.column = caret.value("column").toInt(1) - 1;
+            if (!finish.isEmpty()) {
+                d.endLine = finish.value("line").toInt(1) - 1;
+                d.endColumn = finish.value("column").toInt(1);
+            }
+            d.severity = severityOf(item.value("kind").toString());
+            d.message = item.value("message").toString();
+            d.source = QStringLiteral("gcc");
+            out.append(d);
+        }
+        collectGcc(item.value("children").toArray(), baseDir, out);
+    }
+}
+
+// SARIF 2.1: runs[].results[] con level, message.text y physicalLocation
+void collectSarif(const QJsonObject &log, const QString &baseDir, QVector<Diagnostic> &out) {
+    for (const QJsonValue &run : log.value("runs").toArray()) {
+        const QString tool = run.toObject().value("tool").toObject().value("driver").toObject()
+                                 .value("name").toString().toLower();
+        for (const QJsonValue &value : run.toObject().value("results").toArray()) {
+            const QJsonObject result = value.toObject();
+            const QJsonArray locations = result.value("locations").toArray();
+            if (locations.isEmpty()) continue;
+            const QJsonObject physical = locations.first().toObject().value("physicalLocation").toObject();
+            const QJsonObject region = physical.value("region").toObject();
+            const QString uri = physical.value("artifactLocation").toObject().value("uri").toString();
+
+            Diagnostic d;
+            d.file = resolve(uri.startsWith(QLatin1String("file:")) ? QUrl(uri).toLocalFile() : uri, baseDir);
+            d.line = region.value("startLine").toInt(1) - 1;
+            d.column = region.value("startColumn").toInt(1) - 1;
+            if (region.contains("endLine") || region.contains("endColumn")) {
+                d.endLine = region.value("endLine").toInt(d.line + 1) - 1;
+                d.endColumn = region.value("endColumn").toInt(1) - 1;
+            }
+            d.severity = severityOf(result.value("level").toString(QStringLiteral("warning")));
+            d.message = result.value("message").toObject().value("text").toString();
+            d.source = tool.isEmpty() ? QStringLiteral("sarif") : tool;
+            out.append(d);
+        }
+    }
+}
+
+} // namespace
+
+CompilerOutputParser::CompilerOutputParser(QObject *parent)
+    : QObject(parent) {
+}
+
+void CompilerOutputParser::reset(const QString &baseDir) {
+    m_baseDir = baseDir;
+    m_partial.clear();
+}
+
+// Solo se procesan líneas completas; el resto espera al siguiente trozo
+void CompilerOutputParser::feed(const QByteArray &chunk) {
+    m_partial += chunk;
+    const qsizetype lastNewline = m_partial.lastIndexOf('\n');
+    if (lastNewline < 0) return;
+
+    QVector<Diagnostic> diagnostics;
+    qsizetype start = 0;
+    while (start <= lastNewline) {
+        const qsizetype end = m_partial.indexOf('\n', start);
+        const QByteArray line = m_partial.mid(start, end - start).trimmed();
+        start = end + 1;
+        if (line.isEmpty()) continue;
+        if (line.startsWith('[') || line.startsWith('{')) diagnostics += parseJson(line, m_baseDir);
+        else diagnostics += parseLine(QString::fromLocal8Bit(line), m_baseDir);
+    }
+    m_partial.remove(0, lastNewline + 1);
+    if (!diagnostics.isEmpty()) emit parsed(diagnostics);
+}
+
+void CompilerOutputParser::finish() {
+    if (!m_partial.endsWith('\n')) m_partial += '\n';
+    feed(QByteArray());
+}
+
+QVector<Diagnostic> CompilerOutputParser::parseLine(const QString &line, const QString &baseDir) {
+    // fichero:línea[:columna]: [fatal ]error|warning|note: mensaje
+    static const QRegularExpression re(
+        QStringLiteral("^(.+?):(\\d+):(?:(\\d+):)?\\s*(fatal error|error|warning|note):\\s*(.*)$"));
+    QVector<Diagnostic> result;
+    if (!line.contains(QLatin1String(": "))) return result;
+    const QRegularExpressionMatch m = re.match(line);
+    if (!m.hasMatch()) return result;
+
+    Diagnostic d;
+    d.file = resolve(m.captured(1), baseDir);
+    d.line = m.capturedView(2).toInt() - 1;
+    d.column = m.capturedLength(3) ? m.capturedView(3).toInt() - 1 : 0;
+    d.severity = severityOf(m.capturedView(4));
+    d.message = m.captured(5);
+    d.source = QStringLiteral("compilador");
+    result.append(d);
+    return result;
+}
+
+QVector<Diagnostic> CompilerOutputParser::parseJson(const QByteArray &json, const QString &baseDir) {
+    QVector<Diagnostic> result;
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    if (doc.isArray()) collectGcc(doc.array(), baseDir, result);
+    else if (doc.isObject()) collectSarif(doc.object(), baseDir, result);
+    return result;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include "Diagnostic.h"
+
+// Convierte la salida de GCC y Clang en diagnósticos a medida que llega.
+// Entiende el formato de texto ("fichero:línea:col: error: mensaje"), el
+// JSON de -fdiagnostics-format=json y SARIF (json y sarif en una sola
+// línea, como los emiten ambos compiladores). Vive en su propio hilo:
+// MainWindow le pasa los trozos con feed() por una conexión en cola y
+// recibe cada lote con parsed().
+class CompilerOutputParser : public QObject {
+    Q_OBJECT
+public:
+    explicit CompilerOutputParser(QObject *parent = nullptr);
+
+    // Las rutas relativas se resuelven contra el directorio de compilación
+    static QVector<Diagnostic> parseLine(const QString &line, const QString &baseDir);
+
+public slots:
+    void reset(const QString &baseDir);
+    void feed(const QByteArray &chunk);
+    // Procesa la última línea aunque no termine en '\n'
+    void finish();
+
+signals:
+    void parsed(const QVector<Diagnostic> &diagnostics);
+
+private:
+    static QVector<Diagnostic> parseJson(const QByteArray &json, const QString &baseDir);
+
+    QString m_baseDir;
+    QByteArray m_partial;
+};
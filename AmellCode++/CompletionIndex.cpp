@@ -0,0 +1,263 @@
+#include "CompletionIndex.h"
+
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSet>
+#include <QThreadPool>
+
+#include <algorithm>
+
+static bool isWordChar(QChar c) {
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
+CompletionIndex &CompletionIndex::instance() {
+    static CompletionIndex index;
+    return index;
+}
+
+QStringList CompletionIndex::extractWords(const QString &text) {
+    QStringList words;
+    const int n = text.size();
+    int i = 0;
+    while (i < n) {
+        if (!isWordChar(text[i])) { ++i; continue; }
+        const int start = i;
+        while (i < n && isWordChar(text[i])) ++i;
+        if (i - start >= MIN_WORD_LENGTH && !text[start].isDigit())
+            words.append(text.mid(start, i - start));
+    }
+    return words;
+}
+
+int CompletionIndex::findNode(const QString &word) const {
+    if (m_nodes.empty()) return -1;
+    int node = 0;
+    for (QChar qc : word) {
+        const auto &children = m_nodes[node].children;
+        const char16_t c = qc.unicode();
+        auto it = std::lower_bound(children.begin(), children.end(), c,
+                                   [](const std::pair<char16_t, int> &p, char16_t v) { return p.first < v; });
+        if (it == children.end() || it->first != c) return -1;
+        node = it->second;
+    }
+    return node;
+}
+
+int CompletionIndex::insertPath(const QString &word) {
+    if (m_nodes.empty()) m_nodes.emplace_back();
+    int node = 0;
+    for (QChar qc : word) {
+        const char16_t c = qc.unicode();
+        auto &children = m_nodes[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), c,
+                                   [](const std::pair<char16_t, int> &p, char16_t v) { return p.first < v; });
+        if (it != children.end() && it->first == c) {
+            node = it->second;
+            continue;
+        }
+        const qsizetype at = it - children.begin();
+        // allocateNode puede invalidar 'children', por eso se vuelve a buscar
+        const int child = allocateNode();
+        auto &parent = m_nodes[node].children;
+        parent.insert(parent.begin() + at, {c, child});
+        node = child;
+    }
+    return node;
+}
+
+int CompletionIndex::allocateNode() {
+    if (!m_freeNodes.empty()) {
+        const int node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+        return node;
+    }
+    m_nodes.emplace_back();
+    return static_cast<int>(m_nodes.size()) - 1;
+}
+
+// Quita del trie la rama de 'word' que ya no lleva a ninguna palabra viva;
+// sin esto cada identificador escrito alguna vez ocuparía nodos para siempre
+void CompletionIndex::prune(const QString &word) {
+    if (m_nodes.empty()) return;
+    std::vector<std::pair<int, char16_t>> path; // padre y carácter de cada paso
+    path.reserve(word.size());
+    int node = 0;
+    for (QChar qc : word) {
+        const auto &children = m_nodes[node].children;
+        const char16_t c = qc.unicode();
+        auto it = std::lower_bound(children.begin(), children.end(), c,
+                                   [](const std::pair<char16_t, int> &p, char16_t v) { return p.first < v; });
+        if (it == children.end() || it->first != c) return;
+        path.push_back({node, c});
+        node = it->second;
+    }
+    while (!path.empty()) {
+        const Node &n = m_nodes[node];
+        if (isLive(n) || !n.children.empty()) break;
+        const auto [parent, c] = path.back();
+        path.pop_back();
+        auto &children = m_nodes[parent].children;
+        children.erase(std::lower_bound(children.begin(), children.end(), c,
+                                        [](const std::pair<char16_t, int> &p, char16_t v) { return p.first < v; }));
+        m_nodes[node] = Node();
+        m_freeNodes.push_back(node);
+        node = parent;
+    }
+}
+
+void CompletionIndex::addWords(const QStringList &words) {
+    for (const QString &w : words) {
+        const int node = insertPath(w);
+        if (!isLive(m_nodes[node])) m_terminals.insert(w, node);
+        ++m_nodes[node].count;
+    }
+}
+
+void CompletionIndex::removeWords(const QStringList &words) {
+    for (const QString &w : words) {
+        const int node = findNode(w);
+        if (node < 0 || m_nodes[node].count == 0) continue;
+        if (--m_nodes[node].count == 0 && !m_nodes[node].symbol) {
+            m_terminals.remove(w);
+            prune(w);
+        }
+    }
+}
+
+void CompletionIndex::setSymbol(const QString &word, bool symbol) {
+    const int node = symbol ? insertPath(word) : findNode(word);
+    if (node < 0) return;
+    Node &n = m_nodes[node];
+    n.symbol = symbol;
+    if (isLive(n)) {
+        m_terminals.insert(word, node);
+    } else {
+        m_terminals.remove(word);
+        prune(word);
+    }
+}
+
+void CompletionIndex::setWorkspaceSymbols(const QStringList &symbols) {
+    for (const QString &s : std::as_const(m_workspaceSymbols)) setSymbol(s, false);
+    m_workspaceSymbols = symbols;
+    for (const QString &s : std::as_const(m_workspaceSymbols)) setSymbol(s, true);
+}
+
+// Recorre el proyecto en un hilo del pool y publica los símbolos en el hilo principal
+void CompletionIndex::indexWorkspace(const QString &rootPath) {
+    QThreadPool::globalInstance()->start([rootPath]() {
+        static const QRegularExpression typeDecl(
+            QStringLiteral("\\b(?:class|struct|union|namespace|enum(?:\\s+class)?)\\s+([A-Za-z_]\\w*)"));
+        static const QRegularExpression macroDecl(
+            QStringLiteral("^\\s*#\\s*define\\s+([A-Za-z_]\\w*)"), QRegularExpression::MultilineOption);
+        static const QRegularExpression functionDecl(
+            QStringLiteral("^\\s*(?:[\\w:<>,\\*&~]+\\s+)+[\\*&]*([A-Za-z_]\\w*)\\s*\\("),
+            QRegularExpression::MultilineOption);
+
+        QSet<QString> symbols;
+        const QStringList filters = {"*.h", "*.hh", "*.hpp", "*.c", "*.cc", "*.cpp", "*.cxx"};
+        QDirIterator it(rootPath, filters, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString path = it.next();
+            if (path.contains(QLatin1String("/build/")) || path.contains(QLatin1String("/."))) continue;
+            if (QFileInfo(path).size() > 2 * 1024 * 1024) continue;
+            QFile f(path);
+            if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) continue;
+            const QString text = QString::fromUtf8(f.readAll());
+            for (const QRegularExpression *re : {&typeDecl, &macroDecl, &functionDecl}) {
+                auto m = re->globalMatch(text);
+                while (m.hasNext()) {
+                    const QString name = m.next().captured(1);
+                    if (name.size() >= MIN_WORD_LENGTH) symbols.insert(name);
+                }
+            }
+        }
+
+        const QStringList list(symbols.cbegin(), symbols.cend());
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [list]() {
+            CompletionIndex::instance().setWorkspaceSymbols(list);
+        }, Qt::QueuedConnection);
+    });
+}
+
+// Puntuación difusa: subsecuencia sin distinguir mayúsculas, penalizando huecos
+static int fuzzyScore(const QString &word, const QString &pattern) {
+    if (word.isEmpty() || word[0].toLower() != pattern[0].toLower()) return -1;
+    int wi = 1, gaps = 0;
+    for (int pi = 1; pi < pattern.size(); ++pi) {
+        const QChar p = pattern[pi].toLower();
+        while (wi < word.size() && word[wi].toLower() != p) { ++wi; ++gaps; }
+        if (wi == word.size()) return -1;
+        ++wi;
+    }
+    return 1000 - gaps * 10 - (word.size() - pattern.size());
+}
+
+QStringList CompletionIndex::complete(const QString &prefix, int maxResults) const {
+    QElapsedTimer timer;
+    timer.start();
+
+    struct Candidate { int score; QString word; };
+    QVector<Candidate> exact;
+
+    // ---------- Prefijo: DFS iterativo bajo el nodo del prefijo ----------
+    const int start = prefix.isEmpty() ? -1 : findNode(prefix);
+    if (start >= 0) {
+        QString path = prefix;
+        std::vector<std::pair<int, size_t>> stack{{start, 0}};
+        int visited = 0;
+        while (!stack.empty()) {
+            auto &top = stack.back();
+            const Node &n = m_nodes[top.first];
+            if (top.second < n.children.size()) {
+                const auto child = n.children[top.second++];
+                path.append(QChar(child.first));
+                stack.push_back({child.second, 0});
+                const Node &c = m_nodes[child.second];
+                if (isLive(c)) exact.push_back({score(c), path});
+                if ((++visited & 255) == 0 && timer.nsecsElapsed() > BUDGET_NS) break;
+            } else {
+                stack.pop_back();
+                path.chop(1);
+            }
+        }
+    }
+
+    std::sort(exact.begin(), exact.end(), [](const Candidate &a, const Candidate &b) {
+        if (a.score != b.score) return a.score > b.score;
+        if (a.word.size() != b.word.size()) return a.word.size() < b.word.size();
+        return a.word < b.word;
+    });
+
+    QStringList result;
+    for (const Candidate &c : std::as_const(exact)) {
+        if (result.size() >= maxResults) break;
+        result.append(c.word);
+    }
+
+    // ---------- Búsqueda difusa si el trie dio pocos resultados ----------
+    if (result.size() < maxResults / 4 && prefix.size() >= 2) {
+        QVector<Candidate> fuzzy;
+        int visited = 0;
+        for (auto it = m_terminals.cbegin(); it != m_terminals.cend(); ++it) {
+            if ((++visited & 255) == 0 && timer.nsecsElapsed() > BUDGET_NS) break;
+            const QString &word = it.key();
+            if (word == prefix || word.startsWith(prefix)) continue;
+            const int s = fuzzyScore(word, prefix);
+            if (s >= 0) fuzzy.push_back({s + score(m_nodes[it.value()]), word});
+        }
+        std::sort(fuzzy.begin(), fuzzy.end(), [](const Candidate &a, const Candidate &b) {
+            return a.score != b.score ? a.score > b.score : a.word < b.word;
+        });
+        for (const Candidate &c : std::as_const(fuzzy)) {
+            if (result.size() >= maxResults) break;
+            result.append(c.word);
+        }
+    }
+    return result;
+}
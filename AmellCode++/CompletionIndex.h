@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <utility>
+#include <vector>
+
+// Índice global de identificadores para el autocompletado.
+// Combina la frecuencia de cada palabra en los buffers abiertos (mantenida
+// bloque a bloque por el Editor) con los símbolos del workspace, y responde
+// por prefijo con un trie; si hay pocos resultados cae a una búsqueda difusa.
+class CompletionIndex {
+public:
+    static CompletionIndex &instance();
+
+    void addWords(const QStringList &words);
+    void removeWords(const QStringList &words);
+
+    void setWorkspaceSymbols(const QStringList &symbols);
+    void indexWorkspace(const QString &rootPath);
+
+    // Candidatos ordenados por relevancia; nunca tarda más de BUDGET_NS
+    QStringList complete(const QString &prefix, int maxResults = 40) const;
+
+    static QStringList extractWords(const QString &text);
+
+    static constexpr qint64 BUDGET_NS = 2000000; // 2 ms por pulsación
+    static constexpr int MIN_WORD_LENGTH = 3;
+
+private:
+    struct Node {
+        std::vector<std::pair<char16_t, int>> children; // ordenados por carácter
+        int count = 0;        // apariciones en buffers abiertos
+        bool symbol = false;  // presente en el índice del workspace
+    };
+
+    int findNode(const QString &word) const;
+    int insertPath(const QString &word);
+    int allocateNode();
+    void prune(const QString &word);
+    void setSymbol(const QString &word, bool symbol);
+    static bool isLive(const Node &node) { return node.count > 0 || node.symbol; }
+    static int score(const Node &node) { return node.count + (node.symbol ? 4 : 0); }
+
+    std::vector<Node> m_nodes;          // m_nodes[0] es la raíz; el vector es dueño de todos
+    std::vector<int> m_freeNodes;       // nodos podados que se reutilizan al insertar
+    QHash<QString, int> m_terminals;    // palabra viva -> nodo (para la búsqueda difusa)
+    QStringList m_workspaceSymbols;
+};
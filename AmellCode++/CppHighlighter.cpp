@@ -3,6 +3,7 @@
 #include <QFont>
 #include <QColor>
 #include <QRegularExpression>
+#include <QElapsedTimer>
 
 // Paleta aproximada One Dark
 static const QColor kColorText       = QColor("#ABB2BF");
@@ -16,9 +17,21 @@ static const QColor kColorError      = QColor("#E06C75");
 static const QColor kColorOperator   = QColor("#61AFEF");
 static const QColor kColorClassName  = QColor("#E06C75"); // nombres de clase/struct
 
-// Clase encargada de aplicar resaltado de sintaxis en un QTextDocument
-CppHighlighter::CppHighlighter(QTextDocument *parent) : QSyntaxHighlighter(parent) {
-    m_rules.clear();
+// Palabras de una misma categoría en una sola alternativa: mismo resultado que
+// una expresión por palabra, pero una pasada por bloque en lugar de decenas
+static QRegularExpression wordAlternation(const QStringList &words) {
+    QStringList escaped;
+    for (const QString &w : words) escaped.append(QRegularExpression::escape(w));
+    return QRegularExpression(QStringLiteral("\\b(?:%1)\\b").arg(escaped.join(QLatin1Char('|'))));
+}
+
+// Compila las reglas de C++ una sola vez; las expresiones se optimizan aquí
+// para que ningún documento pague la compilación en su primer bloque
+static CppHighlighter::RuleSet buildRuleSet() {
+    QElapsedTimer timer;
+    timer.start();
+    CppHighlighter::RuleSet set;
+    QVector<CppHighlighter::RuleSet::Rule> &rules = set.rules;
 
     // ---------- Keywords ----------
     const QStringList keywords = {
@@ -36,78 +49,67 @@ CppHighlighter::CppHighlighter(QTextDocument *parent) : QSyntaxHighlighter(paren
     QTextCharFormat keywordFormat;
     keywordFormat.setForeground(kColorKeyword);
     keywordFormat.setFontWeight(QFont::Bold);
-    for (const QString &kw : keywords) {
-        Rule r;
-        r.pattern = QRegularExpression(QStringLiteral("\\b%1\\b").arg(QRegularExpression::escape(kw)));
-        r.format = keywordFormat;
-        m_rules.push_back(r);
-    }
+    rules.push_back({ wordAlternation(keywords), keywordFormat });
 
     // ---------- Types / builtins ----------
     QTextCharFormat typeFormat;
     typeFormat.setForeground(kColorType);
     typeFormat.setFontWeight(QFont::Bold);
     const QStringList types = {"size_t","uint32_t","uint64_t","int32_t","int64_t","std","string","QString","QWidget","QMainWindow"};
-    for (const QString &t : types) {
-        Rule r;
-        r.pattern = QRegularExpression(QStringLiteral("\\b%1\\b").arg(QRegularExpression::escape(t)));
-        r.format = typeFormat;
-        m_rules.push_back(r);
-    }
+    rules.push_back({ wordAlternation(types), typeFormat });
 
     // ---------- Class / Struct names (identifier starting with uppercase) ----------
     QTextCharFormat classFormat;
     classFormat.setForeground(kColorClassName);
     classFormat.setFontWeight(QFont::Bold);
-    m_rules.push_back({ QRegularExpression(QStringLiteral("\\b[A-Z][A-Za-z0-9_]*\\b")), classFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("\\b[A-Z][A-Za-z0-9_]*\\b")), classFormat });
 
     // ---------- Funciones (identificador seguido de '(' ) ----------
     QTextCharFormat functionFormat;
     functionFormat.setForeground(kColorFunction);
     functionFormat.setFontWeight(QFont::Normal);
     // lookahead para "("
-    m_rules.push_back({ QRegularExpression(QStringLiteral("\\b[A-Za-z_][A-Za-z0-9_]*(?=\\s*\\()")), functionFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("\\b[A-Za-z_][A-Za-z0-9_]*(?=\\s*\\()")), functionFormat });
 
     // ---------- Strings (soportando escapes) ----------
     QTextCharFormat stringFormat;
     stringFormat.setForeground(kColorString);
     stringFormat.setFontItalic(false);
     // Cadenas con escapes
-    m_rules.push_back({ QRegularExpression(QStringLiteral("\"(?:\\\\.|[^\\\\\"])*\"")), stringFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("\"(?:\\\\.|[^\\\\\"])*\"")), stringFormat });
     // Caracteres 'a' o '\n'
-    m_rules.push_back({ QRegularExpression(QStringLiteral("'(?:\\\\.|[^\\\\'])'")), stringFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("'(?:\\\\.|[^\\\\'])'")), stringFormat });
     // Raw string literals básicos (bastante permissive)
-    m_rules.push_back({ QRegularExpression(QStringLiteral("R\"\\((?:.|\\n)*?\\)\"")), stringFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("R\"\\((?:.|\\n)*?\\)\"")), stringFormat });
 
     // ---------- Números (decimal, float, exponent, hex) ----------
     QTextCharFormat numberFormat;
     numberFormat.setForeground(kColorNumber);
-    m_rules.push_back({ QRegularExpression(QStringLiteral("\\b0x[0-9A-Fa-f]+\\b")), numberFormat });
-    m_rules.push_back({ QRegularExpression(QStringLiteral("\\b[0-9]+(\\.[0-9]+)?([eE][+-]?[0-9]+)?[uUlLfF]*\\b")), numberFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("\\b0x[0-9A-Fa-f]+\\b")), numberFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("\\b[0-9]+(\\.[0-9]+)?([eE][+-]?[0-9]+)?[uUlLfF]*\\b")), numberFormat });
 
     // ---------- Preprocesador / directivas ----------
     QTextCharFormat preprocFormat;
     preprocFormat.setForeground(kColorOperator);
     preprocFormat.setFontWeight(QFont::Bold);
-    m_rules.push_back({ QRegularExpression(QStringLiteral("^\\s*#\\s*\\w+")), preprocFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("^\\s*#\\s*\\w+")), preprocFormat });
     // Highlight include filename between <> or ""
     QTextCharFormat includeFileFormat;
     includeFileFormat.setForeground(kColorString);
     includeFileFormat.setFontItalic(true);
-    m_rules.push_back({ QRegularExpression(QStringLiteral("#\\s*include\\s*[<\"][^>\"]+[>\"]")), includeFileFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("#\\s*include\\s*[<\"][^>\"]+[>\"]")), includeFileFormat });
 
     // ---------- Comentarios ----------
     QTextCharFormat singleLineCommentFormat;
     singleLineCommentFormat.setForeground(kColorComment);
     singleLineCommentFormat.setFontItalic(true);
-    m_rules.push_back({ QRegularExpression(QStringLiteral("//[^\\n]*")), singleLineCommentFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("//[^\\n]*")), singleLineCommentFormat });
 
     // Multiline comments (handled specially below too)
-    m_commentStart = QRegularExpression(QStringLiteral("/\\*"));
-    m_commentEnd = QRegularExpression(QStringLiteral("\\*/"));
-    m_commentFormat = QTextCharFormat();
-    m_commentFormat.setForeground(kColorComment);
-    m_commentFormat.setFontItalic(true);
+    set.commentStart = QRegularExpression(QStringLiteral("/\\*"));
+    set.commentEnd = QRegularExpression(QStringLiteral("\\*/"));
+    set.commentFormat.setForeground(kColorComment);
+    set.commentFormat.setFontItalic(true);
 
     // ---------- Operadores / símbolos ----------
     QMap<QString, QColor> symbolColors = {
@@ -124,46 +126,169 @@ CppHighlighter::CppHighlighter(QTextDocument *parent) : QSyntaxHighlighter(paren
         QTextCharFormat fmt;
         fmt.setForeground(it.value());
         fmt.setFontWeight(QFont::Normal);
-        m_rules.push_back({ QRegularExpression(QRegularExpression::escape(it.key())), fmt });
+        rules.push_back({ QRegularExpression(QRegularExpression::escape(it.key())), fmt });
     }
 
     // ---------- Errores simples (por ejemplo TODO/FIXME) ----------
     QTextCharFormat todoFormat;
     todoFormat.setForeground(kColorError);
     todoFormat.setFontWeight(QFont::Bold);
-    m_rules.push_back({ QRegularExpression(QStringLiteral("\\b(TODO|FIXME|BUG)\\b")), todoFormat });
+    rules.push_back({ QRegularExpression(QStringLiteral("\\b(TODO|FIXME|BUG)\\b")), todoFormat });
+
+    // ---------- Tokens semánticos (clangd) ----------
+    // Se aplican encima de las reglas léxicas y corrigen sus heurísticas
+    set.semanticFormats[SemanticToken::Type] = classFormat;
+    set.semanticFormats[SemanticToken::Namespace] = typeFormat;
+    set.semanticFormats[SemanticToken::Function] = functionFormat;
+    set.semanticFormats[SemanticToken::Macro] = preprocFormat;
+    set.semanticFormats[SemanticToken::Variable].setForeground(kColorText);
+    set.semanticFormats[SemanticToken::Variable].setFontWeight(QFont::Normal);
+
+    for (auto &rule : rules) rule.pattern.optimize();
+    set.commentStart.optimize();
+    set.commentEnd.optimize();
+
+    set.buildTimeNs = timer.nsecsElapsed();
+    return set;
+}
+
+const CppHighlighter::RuleSet &CppHighlighter::ruleSet() {
+    static const RuleSet set = buildRuleSet();
+    return set;
+}
+
+// Clase encargada de aplicar resaltado de sintaxis en un QTextDocument.
+// Crear uno no compila nada: todas las instancias comparten ruleSet()
+CppHighlighter::CppHighlighter(QTextDocument *parent)
+    : QSyntaxHighlighter(parent),
+      m_rules(ruleSet()),
+      m_brackets(std::make_shared<BracketIndex>()) {
 }
 
 // Método que aplica los formatos en cada bloque de texto
 void CppHighlighter::highlightBlock(const QString &text) {
+    // En una línea larga las reglas solo recorren la ventana que sigue al
+    // cursor: el coste de cada pulsación no depende del largo de la línea
+    const BlockData *data = BlockData::of(currentBlock());
+    int windowStart = 0;
+    QString window = text;
+    if (text.size() > BlockData::LONG_LINE) {
+        windowStart = qBound(0, data ? data->highlightStart : 0, int(text.size()) - BlockData::HIGHLIGHT_WINDOW);
+        window = text.mid(windowStart, BlockData::HIGHLIGHT_WINDOW);
+    }
+
     // Aplica todas las reglas (keywords, tipos, strings, símbolos, etc.)
-    for (const Rule &rule : m_rules) {
-        auto it = rule.pattern.globalMatch(text);
+    for (const RuleSet::Rule &rule : m_rules.rules) {
+        auto it = rule.pattern.globalMatch(window);
         while (it.hasNext()) {
             auto m = it.next();
-            setFormat(m.capturedStart(), m.capturedLength(), rule.format);
+            setFormat(windowStart + m.capturedStart(), m.capturedLength(), rule.format);
         }
     }
 
     // ---------- Comentarios multilínea ----------
+    // También solo en la ventana. Lo que queda antes de ella no se mira: el
+    // bloque empieza dentro de un comentario solo si la ventana empieza en
+    // la columna 0, y el estado final es el del final de la ventana
+    const bool startsInComment = previousBlockState() == 1 && windowStart == 0;
     setCurrentBlockState(0);
-    int startIndex = 0;
-
-    if (previousBlockState() != 1)
-        startIndex = text.indexOf(m_commentStart);
-    else
-        startIndex = 0;
+    int startIndex = startsInComment ? 0 : int(window.indexOf(m_rules.commentStart));
 
     while (startIndex >= 0) {
-        int endIndex = text.indexOf(m_commentEnd, startIndex);
+        int endIndex = window.indexOf(m_rules.commentEnd, startIndex);
         int commentLength;
         if (endIndex == -1) {
             setCurrentBlockState(1);
-            commentLength = text.length() - startIndex;
+            commentLength = window.length() - startIndex;
         } else {
-            commentLength = endIndex - startIndex + m_commentEnd.pattern().length();
+            commentLength = endIndex - startIndex + 2;
+        }
+        setFormat(windowStart + startIndex, commentLength, m_rules.commentFormat);
+        startIndex = window.indexOf(m_rules.commentStart, startIndex + commentLength);
+    }
+
+    updateBrackets(window, windowStart, startsInComment);
+
+    // ---------- Tokens semánticos ----------
+    // Solo si el bloque no cambió desde que llegaron los tokens; se compara
+    // la revisión del bloque y no un hash, que recorrería la línea entera
+    data = BlockData::of(currentBlock());
+    if (data && !data->semanticTokens.isEmpty() && data->semanticRevision == currentBlock().revision()) {
+        const int windowEnd = windowStart + int(window.size());
+        for (const SemanticToken &t : data->semanticTokens) {
+            if (t.start + t.length > windowStart && t.start < windowEnd)
+                setFormat(t.start, t.length, m_rules.semanticFormats[t.kind]);
         }
-        setFormat(startIndex, commentLength, m_commentFormat);
-        startIndex = text.indexOf(m_commentStart, startIndex + commentLength);
     }
+
+    emit blockHighlighted(currentBlock().blockNumber());
+}
+
+// Corchetes fuera de comentarios, cadenas y caracteres; 'inComment' indica
+// que el bloque empieza dentro de un comentario /* */
+static QVector<Bracket> scanBrackets(const QString &text, bool inComment) {
+    QVector<Bracket> brackets;
+    const int n = text.size();
+    int i = 0;
+    while (i < n) {
+        if (inComment) {
+            const int end = text.indexOf(QLatin1String("*/"), i);
+            if (end < 0) break;
+            i = end + 2;
+            inComment = false;
+            continue;
+        }
+        const QChar c = text[i];
+        const QChar next = i + 1 < n ? text[i + 1] : QChar();
+        if (c == QLatin1Char('/') && next == QLatin1Char('/')) break;
+        if (c == QLatin1Char('/') && next == QLatin1Char('*')) {
+            inComment = true;
+            i += 2;
+            continue;
+        }
+        if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            ++i;
+            while (i < n && text[i] != c) i += (text[i] == QLatin1Char('\\')) ? 2 : 1;
+            ++i;
+            continue;
+        }
+        if (BracketIndex::kindOf(c.unicode()) != BracketIndex::KindCount)
+            brackets.append({i, c.unicode()});
+        ++i;
+    }
+    return brackets;
+}
+
+// Actualiza el nodo del bloque en el índice de corchetes. Todos los bloques
+// anteriores ya tienen nodo (el highlighter avanza en orden), así que un
+// bloque nuevo se inserta en la posición de su número de bloque.
+// 'text' es la ventana resaltada, que empieza en la columna 'offset'.
+void CppHighlighter::updateBrackets(const QString &text, int offset, bool inComment) {
+    QTextBlock block = currentBlock();
+    BlockData *data = BlockData::ensure(block);
+    data->brackets = scanBrackets(text, inComment);
+    for (Bracket &b : data->brackets) b.position += offset;
+
+    BracketIndex::Stats stats[BracketIndex::KindCount];
+    for (const Bracket &b : std::as_const(data->brackets)) {
+        BracketIndex::Stats &s = stats[BracketIndex::kindOf(b.ch)];
+        s.delta += BracketIndex::isOpen(b.ch) ? 1 : -1;
+        s.minPrefix = qMin(s.minPrefix, s.delta);
+    }
+
+    // Regiones #if ... #endif (para el plegado)
+    static const QRegularExpression conditional(QStringLiteral("^\\s*#\\s*(if|ifdef|ifndef|endif)\\b"));
+    if (offset == 0 && !inComment && text.contains(QLatin1Char('#'))) {
+        const auto m = conditional.match(text);
+        if (m.hasMatch()) {
+            const bool opens = m.capturedView(1) != QLatin1String("endif");
+            stats[BracketIndex::Directive] = opens ? BracketIndex::Stats{1, 0} : BracketIndex::Stats{-1, -1};
+        }
+    }
+
+    if (!data->bracketNode) {
+        data->bracketNode = m_brackets->insert(block.blockNumber());
+        data->bracketIndex = m_brackets;
+    }
+    m_brackets->update(data->bracketNode, stats);
 }
@@ -3,18 +3,41 @@
 #include <QSyntaxHighlighter>
 #include <QRegularExpression>
 
+#include "BlockData.h"
+#include "BracketIndex.h"
+
+#include <memory>
+
 class CppHighlighter : public QSyntaxHighlighter {
     Q_OBJECT
 public:
+    // Reglas compiladas una vez por proceso e inmutables; todas las
+    // instancias las comparten por referencia
+    struct RuleSet {
+        struct Rule { QRegularExpression pattern; QTextCharFormat format; };
+        QVector<Rule> rules;
+        QRegularExpression commentStart;
+        QRegularExpression commentEnd;
+        QTextCharFormat commentFormat;
+        QTextCharFormat semanticFormats[SemanticToken::KindCount];
+        qint64 buildTimeNs = 0;     // métrica de arranque
+    };
+    static const RuleSet &ruleSet();
+
     explicit CppHighlighter(QTextDocument *parent = nullptr);
 
+    const BracketIndex &brackets() const { return *m_brackets; }
+
+signals:
+    // Los formatos del bloque se recalcularon (minimapa)
+    void blockHighlighted(int blockNumber);
+
 protected:
     void highlightBlock(const QString &text) override;
 
 private:
-    struct Rule { QRegularExpression pattern; QTextCharFormat format; };
-    QVector<Rule> m_rules;
-    QRegularExpression m_commentStart;
-    QRegularExpression m_commentEnd;
-    QTextCharFormat m_commentFormat;
+    void updateBrackets(const QString &text, int offset, bool inComment);
+
+    const RuleSet &m_rules;
+    std::shared_ptr<BracketIndex> m_brackets;
 };
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+// Diagnóstico de compilador o servidor de lenguaje. Líneas y columnas
+// empiezan en 0, igual que en LSP y en QTextBlock::blockNumber().
+struct Diagnostic {
+    enum Severity { Error = 1, Warning = 2, Information = 3, Hint = 4 };
+
+    QString file;
+    int line = 0;
+    int column = 0;
+    int endLine = -1;    // -1: hasta el final de la palabra en (line, column)
+    int endColumn = -1;
+    Severity severity = Error;
+    QString message;
+    QString source;
+};
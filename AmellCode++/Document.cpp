@@ -0,0 +1,396 @@
+#include "Document.h"
+#include "CppHighlighter.h"
+#include "CompletionIndex.h"
+#include "LineDiff.h"
+#include "LspClient.h"
+#include "UndoHistory.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QPlainTextDocumentLayout>
+#include <QPointer>
+#include <QSettings>
+#include <QThreadPool>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+
+#include <utility>
+
+// Con un qHash, dos textos distintos con el mismo valor harían pasar un
+// cambio real en disco por nuestro propio guardado
+static QByteArray diskHash(const QString &text) {
+    return QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha1);
+}
+
+Document::Document(const QString &text, const TokenCache &tokens, QObject *parent)
+    : QObject(parent),
+      m_document(new QTextDocument(this)),
+      m_highlighter(nullptr),
+      m_history(nullptr) {
+    m_document->setDocumentLayout(new QPlainTextDocumentLayout(m_document));
+    m_document->setPlainText(text);
+    m_diskHash = diskHash(text);
+    reindexWords(m_document->begin(), m_document->blockCount() - 1);
+    for (QTextBlock b = m_document->begin(); b.isValid() && !m_hasLongLines; b = b.next())
+        m_hasLongLines = BlockData::isLong(b);
+
+    for (const CachedLine &cached : tokens) {
+        QTextBlock block = m_document->findBlockByNumber(cached.line);
+        // La caché viene de otra sesión: el hash del texto dice si sigue valiendo
+        if (!block.isValid() || qHash(block.text()) != cached.hash) continue;
+        BlockData *data = BlockData::ensure(block);
+        data->semanticTokens = cached.tokens;
+        data->semanticRevision = block.revision();
+    }
+
+    // El highlighter se crea con el texto ya puesto: un único pase completo
+    m_highlighter = new CppHighlighter(m_document);
+
+    // Historial propio con presupuesto de memoria; el de QTextDocument guarda
+    // formatos y crece sin límite
+    m_document->setUndoRedoEnabled(false);
+    m_history = new UndoHistory(m_document);
+    m_history->setMemoryBudget(QSettings().value(QStringLiteral("editor/undoMemoryMB"), 32).toLongLong() * 1024 * 1024);
+
+    m_lspBlockCount = m_document->blockCount();
+    m_lspLastLineLength = m_document->lastBlock().text().size();
+    connect(m_document, &QTextDocument::contentsChange, this, &Document::onContentsChange);
+}
+
+void Document::setFilePath(const QString &filePath) {
+    if (filePath == m_filePath) return;
+    m_filePath = filePath;
+    emit filePathChanged(m_filePath);
+}
+
+bool Document::save(const QString &filePath) {
+    QFile f(filePath);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    const QString text = m_document->toPlainText();
+    f.write(text.toUtf8());
+    f.close();
+    m_diskHash = diskHash(text);
+    m_declinedHash.clear();
+
+    if (filePath != m_filePath) {
+        LspClient *client = m_lspClient;
+        setLanguageClient(nullptr);
+        setFilePath(filePath);
+        setLanguageClient(client);
+    } else if (m_lspClient) {
+        m_lspClient->didSave(m_filePath);
+    }
+    m_document->setModified(false);
+    emit saved();
+    return true;
+}
+
+bool Document::isModified() const {
+    return m_document->isModified();
+}
+
+// ---------- Recarga desde disco ----------
+
+void Document::reloadFromDisk(bool discardChanges) {
+    if (m_filePath.isEmpty() || m_tailing) return;
+    if (m_reloading) {
+        m_reloadPending = true;
+        return;
+    }
+    m_reloading = true;
+
+    const QString path = m_filePath;
+    const QString oldText = m_document->toPlainText();
+    const int revision = m_document->revision();
+    QPointer<Document> guard(this);
+    QThreadPool::globalInstance()->start([path, oldText, revision, guard, discardChanges]() {
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [guard]() {
+                if (guard) guard->m_reloading = false;
+            }, Qt::QueuedConnection);
+            return;
+        }
+        const QString newText = QString::fromUtf8(f.readAll());
+        const QByteArray hash = diskHash(newText);
+        const QVector<DiffHunk> hunks = diffLines(oldText.split(QLatin1Char('\n')), newText.split(QLatin1Char('\n')));
+
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, hash, hunks, revision, discardChanges]() {
+            if (!guard) return;
+            Document *self = guard;
+            self->m_reloading = false;
+            const bool again = std::exchange(self->m_reloadPending, false);
+
+            if (self->m_document->revision() != revision) {
+                // Se editó mientras se calculaba la diferencia: otra vuelta
+                self->reloadFromDisk(discardChanges);
+                return;
+            }
+            // Nuestro propio guardado, o un toque al fichero sin cambios
+            if (hash == self->m_diskHash && !discardChanges) {
+                if (again) self->reloadFromDisk();
+                return;
+            }
+            if (self->isModified() && !discardChanges) {
+                // Se pregunta una vez por cada versión del disco: si se
+                // rechaza, los avisos siguientes con el mismo texto se
+                // ignoran y la relectura pendiente se descarta
+                if (self->m_declinedHash == hash) return;
+                self->m_declinedHash = hash;
+                self->m_reloadPending = false;
+                emit self->changedOnDisk();
+                return;
+            }
+            self->applyHunks(hunks);
+            self->m_diskHash = hash;
+            self->m_declinedHash.clear();
+            self->m_document->setModified(false);
+            if (again) self->reloadFromDisk();
+        }, Qt::QueuedConnection);
+    });
+}
+
+// Cada trozo es una edición propia, así el highlighter y clangd solo ven las
+// líneas tocadas; el historial los agrupa en un único paso de deshacer
+void Document::applyHunks(const QVector<DiffHunk> &hunks) {
+    if (hunks.isEmpty()) return;
+    emit aboutToReload();
+    m_history->beginGroup();
+    for (auto it = hunks.crbegin(); it != hunks.crend(); ++it) {
+        const DiffHunk &hunk = *it;
+        const int endLine = hunk.oldStart + hunk.oldCount;
+        int from = 0, to = m_document->characterCount() - 1;
+        QString text;
+        if (endLine < m_document->blockCount()) {
+            from = m_document->findBlockByNumber(hunk.oldStart).position();
+            to = m_document->findBlockByNumber(endLine).position();
+            for (const QString &line : hunk.newLines) text += line + QLatin1Char('\n');
+        } else if (hunk.oldStart > 0) {
+            // Toca la última línea: se come el salto de línea anterior
+            const QTextBlock previous = m_document->findBlockByNumber(hunk.oldStart - 1);
+            from = previous.position() + previous.length() - 1;
+            for (const QString &line : hunk.newLines) text += QLatin1Char('\n') + line;
+        } else {
+            text = hunk.newLines.join(QLatin1Char('\n'));
+        }
+
+        m_history->prepare(from, to);
+        QTextCursor cursor(m_document);
+        cursor.beginEditBlock();
+        cursor.setPosition(from);
+        cursor.setPosition(to, QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
+        if (!text.isEmpty()) cursor.insertText(text);
+        cursor.endEditBlock();
+    }
+    m_history->endGroup();
+    emit reloaded();
+}
+
+// ---------- Seguir el final ----------
+
+bool Document::setTailMode(bool enabled) {
+    if (enabled == m_tailing) return true;
+    if (enabled) {
+        if (m_filePath.isEmpty() || isModified()) return false;
+        QFile f(m_filePath);
+        if (!f.open(QIODevice::ReadOnly)) return false;
+
+        // Se parte del contenido actual del disco, aplicado como diferencia
+        m_tailOffset = 0;
+        m_tailDecoder = QStringDecoder(QStringDecoder::Utf8);
+        const QString text = readTailText(f, f.size());
+        applyHunks(diffLines(m_document->toPlainText().split(QLatin1Char('\n')), text.split(QLatin1Char('\n'))));
+        m_diskHash = diskHash(text);
+
+        // Un log no es C++: clangd no lo sigue mientras crece
+        m_tailLspClient = m_lspClient;
+        setLanguageClient(nullptr);
+        m_tailing = true;
+        m_document->setMaximumBlockCount(QSettings().value(QStringLiteral("editor/tailMaxLines"), 200000).toInt());
+        m_history->clear();
+    } else {
+        m_tailing = false;
+        m_document->setMaximumBlockCount(0);
+        setLanguageClient(m_tailLspClient);
+        m_tailLspClient = nullptr;
+    }
+    m_document->setModified(false);
+    emit tailModeChanged(m_tailing);
+    return true;
+}
+
+// Añade al final lo escrito desde la última lectura en una única edición: el
+// highlighter solo procesa los bloques nuevos. Si el fichero encogió (rotado
+// o truncado) se vuelve a empezar desde el principio.
+void Document::readTail() {
+    if (!m_tailing) return;
+    QFile f(m_filePath);
+    if (!f.open(QIODevice::ReadOnly)) return;
+    const qint64 size = f.size();
+    if (size == m_tailOffset) return;
+
+    emit tailAboutToAppend();
+    QTextCursor cursor(m_document);
+    if (size < m_tailOffset) {
+        m_tailOffset = 0;
+        m_tailDecoder = QStringDecoder(QStringDecoder::Utf8);
+        cursor.select(QTextCursor::Document);
+    } else {
+        cursor.movePosition(QTextCursor::End);
+    }
+    cursor.insertText(readTailText(f, size));
+    m_document->setModified(false);
+    emit tailAppended();
+}
+
+// Lee de m_tailOffset a 'size' sin pasar de tailMaxReadMB: un log que
+// escupe cientos de MB entre dos avisos no se carga entero en memoria
+QString Document::readTailText(QFile &file, qint64 size) {
+    const qint64 maxRead = QSettings().value(QStringLiteral("editor/tailMaxReadMB"), 8).toLongLong() << 20;
+    // Añadiendo tras una línea a medias, el aviso va en una línea propia
+    const bool midLine = m_tailOffset > 0 && !m_document->lastBlock().text().isEmpty();
+    QString gap;
+    if (size - m_tailOffset > maxRead) {
+        const qint64 skipped = size - maxRead - m_tailOffset;
+        m_tailOffset = size - maxRead;
+        m_tailDecoder = QStringDecoder(QStringDecoder::Utf8);
+        gap = tr("[… %1 MB omitidos …]").arg(QString::number(skipped / double(1 << 20), 'f', 1));
+    }
+    file.seek(m_tailOffset);
+    QByteArray bytes = file.read(size - m_tailOffset);
+    m_tailOffset = size;
+    if (!gap.isEmpty()) {
+        // Se empieza en la primera línea completa tras el salto
+        const qsizetype newline = bytes.indexOf('\n');
+        bytes.remove(0, newline < 0 ? bytes.size() : newline + 1);
+        gap = (midLine ? QStringLiteral("\n") : QString()) + gap + QLatin1Char('\n');
+    }
+    QString text = gap + m_tailDecoder.decode(bytes);
+    text.remove(QLatin1Char('\r'));
+    return text;
+}
+
+void Document::setLanguageClient(LspClient *client) {
+    if (m_tailing) {
+        // Se aplica al salir del modo de seguimiento
+        m_tailLspClient = client;
+        return;
+    }
+    if (m_lspClient) {
+        disconnect(m_lspClient, nullptr, this, nullptr);
+        if (!m_filePath.isEmpty()) m_lspClient->didClose(m_filePath);
+        m_diagnostics.remove(QStringLiteral("clangd"));
+        emit diagnosticsChanged();
+    }
+    m_lspClient = client;
+    if (!client) return;
+
+    connect(client, &LspClient::diagnosticsPublished, this,
+            [this](const QString &filePath, const QVector<Diagnostic> &diagnostics) {
+        if (!m_filePath.isEmpty() && QFileInfo(m_filePath).absoluteFilePath() == filePath)
+            setDiagnostics(QStringLiteral("clangd"), diagnostics);
+    });
+    if (!m_filePath.isEmpty()) client->didOpen(m_filePath, m_document->toPlainText());
+    m_lspBlockCount = m_document->blockCount();
+    m_lspLastLineLength = m_document->lastBlock().text().size();
+}
+
+void Document::setDiagnostics(const QString &source, const QVector<Diagnostic> &diagnostics) {
+    if (diagnostics.isEmpty()) m_diagnostics.remove(source);
+    else m_diagnostics.insert(source, diagnostics);
+    emit diagnosticsChanged();
+}
+
+void Document::addView() {
+    emit viewCountChanged(++m_viewCount);
+}
+
+void Document::removeView() {
+    emit viewCountChanged(--m_viewCount);
+}
+
+Document::TokenCache Document::tokenCache() const {
+    TokenCache cache;
+    for (QTextBlock b = m_document->begin(); b.isValid(); b = b.next()) {
+        const BlockData *data = BlockData::of(b);
+        if (data && !data->semanticTokens.isEmpty() && data->semanticRevision == b.revision())
+            cache.append({b.blockNumber(), qHash(b.text()), data->semanticTokens});
+    }
+    return cache;
+}
+
+qint64 Document::memoryCost() const {
+    return qint64(m_document->characterCount()) * 24 + qint64(m_document->blockCount()) * 256;
+}
+
+// Reindexa solo los bloques tocados por la edición; los bloques eliminados
+// se descuentan del índice en el destructor de BlockData
+void Document::onContentsChange(int position, int charsRemoved, int charsAdded) {
+    QTextBlock block = m_document->findBlock(position);
+    const int end = qMin(position + charsAdded, m_document->characterCount() - 1);
+    const int firstBlock = block.blockNumber();
+    const int lastBlock = m_document->findBlock(end).blockNumber();
+
+    // ---------- LSP: didChange incremental ----------
+    // Las líneas anteriores a firstBlock y posteriores a lastBlock no cambiaron,
+    // así que en el documento viejo el rango tocado acaba en oldLastBlock
+    const int blockCount = m_document->blockCount();
+    if (m_lspClient && !m_filePath.isEmpty()) {
+        if (firstBlock == lastBlock && blockCount == m_lspBlockCount
+            && position + charsAdded < m_document->characterCount()) {
+            // Edición dentro de una línea: se envía solo el fragmento, no la
+            // línea entera (que puede medir megas en un fichero minificado)
+            const int column = position - block.position();
+            QTextCursor cursor(m_document);
+            cursor.setPosition(position);
+            cursor.setPosition(position + charsAdded, QTextCursor::KeepAnchor);
+            m_lspClient->didChange(m_filePath, firstBlock, column, firstBlock, column + charsRemoved,
+                                   cursor.selectedText());
+        } else {
+            const int oldLastBlock = lastBlock - (blockCount - m_lspBlockCount);
+            const bool atEnd = lastBlock == blockCount - 1;
+            QString text;
+            for (QTextBlock b = block; b.isValid() && b.blockNumber() <= lastBlock; b = b.next()) {
+                text += b.text();
+                if (!atEnd || b.blockNumber() < lastBlock) text += QLatin1Char('\n');
+            }
+            if (atEnd)
+                m_lspClient->didChange(m_filePath, firstBlock, 0, oldLastBlock, m_lspLastLineLength, text);
+            else
+                m_lspClient->didChange(m_filePath, firstBlock, 0, oldLastBlock + 1, 0, text);
+        }
+    }
+    m_lspBlockCount = blockCount;
+    m_lspLastLineLength = m_document->lastBlock().text().size();
+
+    for (QTextBlock b = block; b.isValid() && b.blockNumber() <= lastBlock; b = b.next()) {
+        if (!m_hasLongLines && BlockData::isLong(b)) {
+            m_hasLongLines = true;
+            emit longLinesDetected();
+        }
+    }
+    // Las palabras de un log no alimentan el autocompletado
+    if (!m_tailing) reindexWords(block, lastBlock);
+}
+
+void Document::reindexWords(QTextBlock block, int lastBlock) {
+    CompletionIndex &index = CompletionIndex::instance();
+    while (block.isValid() && block.blockNumber() <= lastBlock) {
+        // De una línea larga solo se indexa el principio: extraer y comparar
+        // todas sus palabras en cada pulsación no tiene cota
+        const QString text = block.text();
+        const QStringList words = CompletionIndex::extractWords(
+            BlockData::isLong(block) ? text.left(BlockData::LONG_LINE) : text);
+        BlockData *data = BlockData::ensure(block);
+        if (words != data->words) {
+            index.removeWords(data->words);
+            index.addWords(words);
+            data->words = words;
+        }
+        block = block.next();
+    }
+}
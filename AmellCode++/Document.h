@@ -0,0 +1,126 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QStringDecoder>
+#include <QVector>
+
+#include "BlockData.h"
+#include "Diagnostic.h"
+
+class CppHighlighter;
+class LspClient;
+class QFile;
+struct DiffHunk;
+class QTextBlock;
+class QTextDocument;
+class UndoHistory;
+
+// Estado de un fichero abierto, independiente de la vista que lo muestra:
+// texto, resaltado, historial de deshacer, diagnósticos y sincronización con
+// clangd. Los Editor solo apuntan a él, así que cambiar de pestaña no copia nada.
+class Document : public QObject {
+    Q_OBJECT
+public:
+    // Tokens semánticos de una línea junto al hash del texto al que corresponden
+    struct CachedLine {
+        int line;
+        size_t hash;
+        QVector<SemanticToken> tokens;
+    };
+    using TokenCache = QVector<CachedLine>;
+
+    // 'tokens' se asigna antes del primer resaltado, así una pestaña que se
+    // recarga no espera a clangd para recuperar sus colores
+    explicit Document(const QString &text = QString(), const TokenCache &tokens = {},
+                      QObject *parent = nullptr);
+
+    QTextDocument *textDocument() const { return m_document; }
+    CppHighlighter *highlighter() const { return m_highlighter; }
+    UndoHistory *history() const { return m_history; }
+
+    const QString &filePath() const { return m_filePath; }
+    void setFilePath(const QString &filePath);
+    bool save(const QString &filePath);
+    bool isModified() const;
+
+    // Relee el fichero en un hilo del pool y aplica solo las líneas que
+    // cambiaron, conservando historial, cursores y resaltado del resto. Si el
+    // documento tiene cambios sin guardar no toca nada y emite changedOnDisk()
+    // salvo que 'discardChanges' lo autorice.
+    void reloadFromDisk(bool discardChanges = false);
+
+    // Modo "seguir el final" para logs que crecen: cada aviso del watcher
+    // añade solo los bytes escritos desde la última lectura y las líneas más
+    // antiguas se descartan por encima de tailMaxLines. Cada lectura se
+    // limita a los últimos tailMaxReadMB: si se escribió más de golpe, lo
+    // anterior se salta y se marca con una línea de aviso. Falla si hay
+    // cambios sin guardar.
+    bool setTailMode(bool enabled);
+    bool isTailing() const { return m_tailing; }
+    void readTail();
+
+    // Abre el documento en clangd (o lo cierra si 'client' es nulo)
+    void setLanguageClient(LspClient *client);
+    LspClient *languageClient() const { return m_lspClient; }
+
+    // Reemplaza los diagnósticos de una fuente (clangd, compilador...)
+    void setDiagnostics(const QString &source, const QVector<Diagnostic> &diagnostics);
+    const QHash<QString, QVector<Diagnostic>> &diagnostics() const { return m_diagnostics; }
+
+    // Editores que muestran el documento; con más de uno comparten layout
+    void addView();
+    void removeView();
+    int viewCount() const { return m_viewCount; }
+
+    // Alguna línea supera BlockData::LONG_LINE; no se desactiva al acortarla
+    bool hasLongLines() const { return m_hasLongLines; }
+
+    TokenCache tokenCache() const;
+    // Estimación de lo que ocupa el QTextDocument con su layout y datos por bloque
+    qint64 memoryCost() const;
+
+signals:
+    void diagnosticsChanged();
+    void filePathChanged(const QString &filePath);
+    void viewCountChanged(int count);
+    void longLinesDetected();
+    void changedOnDisk();
+    void aboutToReload();
+    void reloaded();
+    void tailModeChanged(bool enabled);
+    void tailAboutToAppend();
+    void tailAppended();
+    void saved();
+
+private slots:
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+
+private:
+    void reindexWords(QTextBlock block, int lastBlock);
+    void applyHunks(const QVector<DiffHunk> &hunks);
+    QString readTailText(QFile &file, qint64 size);
+
+    QTextDocument *m_document;
+    CppHighlighter *m_highlighter;
+    UndoHistory *m_history;
+    QString m_filePath;
+    QByteArray m_diskHash;            // SHA-1 del fichero tal como se leyó o guardó
+    QByteArray m_declinedHash;        // versión en disco que el usuario no quiso recargar
+    bool m_reloading = false;
+    bool m_reloadPending = false;
+
+    bool m_tailing = false;
+    qint64 m_tailOffset = 0;          // bytes del fichero ya mostrados
+    QStringDecoder m_tailDecoder;     // guarda secuencias UTF-8 cortadas entre lecturas
+    LspClient *m_tailLspClient = nullptr;
+
+    LspClient *m_lspClient = nullptr;
+    int m_lspBlockCount = 1;          // estado del documento tal como lo conoce clangd
+    int m_lspLastLineLength = 0;
+
+    QHash<QString, QVector<Diagnostic>> m_diagnostics;
+    int m_viewCount = 0;
+    bool m_hasLongLines = false;
+};
@@ -0,0 +1,411 @@
+#include "DocumentTabs.h"
+#include "LspClient.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QMessageBox>
+#include <QSettings>
+#include <QSplitter>
+#include <QTabBar>
+#include <QTextDocument>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include <utility>
+
+DocumentTabs::DocumentTabs(QWidget *parent)
+    : QWidget(parent),
+      m_tabBar(new QTabBar(this)),
+      m_splitter(new QSplitter(this)),
+      m_editor(nullptr),
+      m_watcher(new QFileSystemWatcher(this)),
+      m_reloadTimer(new QTimer(this)) {
+    m_budget = QSettings().value(QStringLiteral("tabs/memoryBudgetMB"), 256).toLongLong() * 1024 * 1024;
+
+    m_tabBar->setTabsClosable(true);
+    m_tabBar->setMovable(true);
+    m_tabBar->setDocumentMode(true);
+    m_tabBar->setExpanding(false);
+    m_tabBar->setElideMode(Qt::ElideMiddle);
+
+    // El Editor necesita un documento desde el principio: la primera pestaña
+    Tab first;
+    first.untitledName = tr("Sin título %1").arg(++m_untitledCount);
+    m_tabs.append(first);
+    m_editor = createView(load(m_tabs.first()));
+    m_tabBar->addTab(QString());
+    updateTitle(0);
+    m_current = 0;
+    m_tabs.first().lastUsed = ++m_useCounter;
+
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+    layout->addWidget(m_tabBar);
+    layout->addWidget(m_splitter);
+
+    connect(m_tabBar, &QTabBar::currentChanged, this, &DocumentTabs::onCurrentChanged);
+    connect(m_tabBar, &QTabBar::tabMoved, this, &DocumentTabs::onTabMoved);
+    connect(m_tabBar, &QTabBar::tabCloseRequested, this, [this](int index) { closeTab(index); });
+
+    m_reloadTimer->setSingleShot(true);
+    m_reloadTimer->setInterval(200);
+    connect(m_reloadTimer, &QTimer::timeout, this, &DocumentTabs::reloadChangedFiles);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &path) {
+        // Sin reiniciar el temporizador: un log que se escribe sin parar se
+        // sigue leyendo cada intervalo en lugar de esperar a que calle
+        m_changedFiles.insert(path);
+        if (!m_reloadTimer->isActive()) m_reloadTimer->start();
+    });
+
+    // La barra de pestañas sigue a la vista que tiene el foco
+    connect(qApp, &QApplication::focusChanged, this, [this](QWidget *, QWidget *now) {
+        for (Editor *view : std::as_const(m_views)) {
+            if (view == now) setActiveView(view);
+        }
+    });
+}
+
+// Las vistas se van antes que los documentos que muestran
+DocumentTabs::~DocumentTabs() {
+    disconnect(qApp, nullptr, this, nullptr);
+    qDeleteAll(m_views);
+    m_views.clear();
+    m_editor = nullptr;
+}
+
+Document *DocumentTabs::currentDocument() const {
+    return m_editor->currentDocument();
+}
+
+void DocumentTabs::setLanguageClient(LspClient *client) {
+    m_lspClient = client;
+    for (const Tab &tab : std::as_const(m_tabs)) {
+        if (tab.document) tab.document->setLanguageClient(client);
+    }
+}
+
+void DocumentTabs::setMemoryBudget(qint64 bytes) {
+    m_budget = bytes;
+    enforceBudget();
+}
+
+// ---------- Abrir, guardar y cerrar ----------
+
+void DocumentTabs::newDocument() {
+    Tab tab;
+    tab.untitledName = tr("Sin título %1").arg(++m_untitledCount);
+    m_tabBar->setCurrentIndex(addTab(tab));
+}
+
+void DocumentTabs::openFile(const QString &filePath) {
+    const QString absolute = QFileInfo(filePath).absoluteFilePath();
+    for (int i = 0; i < m_tabs.size(); ++i) {
+        if (!m_tabs[i].filePath.isEmpty() && QFileInfo(m_tabs[i].filePath).absoluteFilePath() == absolute) {
+            m_tabBar->setCurrentIndex(i);
+            return;
+        }
+    }
+    if (!QFileInfo(filePath).isReadable()) return;
+
+    Tab tab;
+    tab.filePath = filePath;
+    m_tabBar->setCurrentIndex(addTab(tab));
+}
+
+void DocumentTabs::save() {
+    m_editor->save();
+}
+
+bool DocumentTabs::closeTab(int index) {
+    if (index < 0 || index >= m_tabs.size()) return false;
+    if (isModified(m_tabs[index])) {
+        const QString name = m_tabBar->tabText(index).remove(QLatin1Char('*'));
+        const auto answer = QMessageBox::question(this, tr("Cerrar"), tr("¿Guardar los cambios de %1?").arg(name),
+                                                  QMessageBox::Save | QMessageBox::Discard | QMessageBox::Cancel);
+        if (answer == QMessageBox::Cancel) return false;
+        if (answer == QMessageBox::Save) {
+            m_tabBar->setCurrentIndex(index);
+            if (!m_editor->save()) return false;
+        }
+    }
+
+    // Siempre queda una pestaña: el Editor no puede quedarse sin documento
+    if (m_tabs.size() == 1) newDocument();
+
+    Document *document = m_tabs[index].document;
+    if (document) {
+        document->setLanguageClient(nullptr);
+        unwatch(document->filePath());
+    }
+    m_tabs.remove(index);
+    if (m_current == index) m_current = -1;
+    else if (m_current > index) --m_current;
+    m_tabBar->removeTab(index);
+
+    // removeTab ya cambió la vista activa; las demás pasan a su documento
+    for (Editor *view : std::as_const(m_views)) {
+        if (view != m_editor && view->currentDocument() == document)
+            view->showDocument(m_editor->currentDocument(), m_editor->viewState());
+    }
+    delete document;
+    return true;
+}
+
+bool DocumentTabs::closeAll() {
+    for (int i = m_tabs.size() - 1; i >= 0; --i) {
+        if (isModified(m_tabs[i]) && !closeTab(i)) return false;
+    }
+    return true;
+}
+
+// ---------- Vistas ----------
+
+Editor *DocumentTabs::createView(Document *document) {
+    Editor *view = new Editor(document, m_splitter);
+    m_splitter->addWidget(view);
+    m_views.append(view);
+    connect(view, &Editor::zoomLevelChanged, this, [this, view]() { syncZoom(view); });
+    return view;
+}
+
+void DocumentTabs::split(Qt::Orientation orientation) {
+    m_splitter->setOrientation(orientation);
+    if (m_views.size() > 1) return;
+
+    Document *document = m_editor->currentDocument();
+    // La vista nueva adopta el zoom del documento al mostrarlo
+    Editor *view = createView(document);
+    view->showDocument(document, m_editor->viewState());
+    view->setFocus();
+}
+
+void DocumentTabs::unsplit() {
+    for (Editor *view : std::as_const(m_views)) {
+        if (view == m_editor) continue;
+        // Una pestaña que solo estaba en la otra vista conserva su posición
+        const int index = indexOf(view->currentDocument());
+        if (index >= 0 && index != m_current) m_tabs[index].view = view->viewState();
+        delete view;
+    }
+    m_views = {m_editor};
+}
+
+void DocumentTabs::setActiveView(Editor *view) {
+    if (view == m_editor) return;
+    if (m_current >= 0 && m_current < m_tabs.size())
+        m_tabs[m_current].view = m_editor->viewState();
+    const Document *previous = m_editor->currentDocument();
+    m_editor = view;
+    m_current = indexOf(view->currentDocument());
+    m_tabBar->setCurrentIndex(m_current);
+    if (view->currentDocument() != previous) emit currentDocumentChanged(view->currentDocument());
+}
+
+// Qt guarda la fuente en el QTextDocument, así que dos vistas del mismo
+// documento no pueden mostrar tamaños distintos: la otra adopta el nivel sin
+// volver a tocar el documento, que ya tiene la fuente nueva
+void DocumentTabs::syncZoom(Editor *source) {
+    for (Editor *view : std::as_const(m_views)) {
+        if (view != source && view->currentDocument() == source->currentDocument())
+            view->followZoomLevel(source->zoomLevel());
+    }
+}
+
+bool DocumentTabs::isShown(const Document *document) const {
+    for (const Editor *view : m_views) {
+        if (view->currentDocument() == document) return true;
+    }
+    return false;
+}
+
+// ---------- Pestañas ----------
+
+int DocumentTabs::addTab(Tab tab) {
+    m_tabs.append(tab);
+    const int index = m_tabBar->addTab(QString());
+    updateTitle(index);
+    return index;
+}
+
+void DocumentTabs::onCurrentChanged(int index) {
+    if (index < 0 || index >= m_tabs.size()) return;
+    // removeTab reenvía el índice desplazado de la pestaña que ya se mostraba
+    if (index == m_current && m_tabs[index].document == m_editor->currentDocument()) return;
+
+    if (m_current >= 0 && m_current < m_tabs.size() && m_tabs[m_current].document)
+        m_tabs[m_current].view = m_editor->viewState();
+
+    m_current = index;
+    Tab &tab = m_tabs[index];
+    Document *document = load(tab);
+    tab.lastUsed = ++m_useCounter;
+    m_editor->showDocument(document, tab.view);
+    enforceBudget();
+    emit currentDocumentChanged(document);
+}
+
+void DocumentTabs::onTabMoved(int from, int to) {
+    m_tabs.move(from, to);
+    m_current = m_tabBar->currentIndex();
+}
+
+void DocumentTabs::updateTitle(int index) {
+    if (index < 0 || index >= m_tabs.size()) return;
+    const Tab &tab = m_tabs[index];
+    QString title = tab.filePath.isEmpty() ? tab.untitledName : QFileInfo(tab.filePath).fileName();
+    if (isModified(tab)) title += QLatin1Char('*');
+    m_tabBar->setTabText(index, title);
+    m_tabBar->setTabToolTip(index, tab.filePath);
+}
+
+int DocumentTabs::indexOf(const Document *document) const {
+    for (int i = 0; i < m_tabs.size(); ++i) {
+        if (m_tabs[i].document == document) return i;
+    }
+    return -1;
+}
+
+bool DocumentTabs::isModified(const Tab &tab) const {
+    return tab.document ? tab.document->isModified() : !tab.compressed.isEmpty();
+}
+
+// ---------- Carga y descarga ----------
+
+Document *DocumentTabs::load(Tab &tab) {
+    if (tab.document) return tab.document;
+
+    QString text;
+    const bool modified = !tab.compressed.isEmpty();
+    if (modified) {
+        text = QString::fromUtf8(qUncompress(tab.compressed));
+        tab.compressed.clear();
+    } else if (!tab.filePath.isEmpty()) {
+        QFile f(tab.filePath);
+        if (f.open(QIODevice::ReadOnly | QIODevice::Text))
+            text = QString::fromUtf8(f.readAll());
+    }
+
+    Document *document = new Document(text, tab.tokens, this);
+    tab.tokens.clear();
+    document->setFilePath(tab.filePath);
+    document->textDocument()->setModified(modified);
+    document->setLanguageClient(m_lspClient);
+
+    connect(document->textDocument(), &QTextDocument::modificationChanged, this, [this, document]() {
+        updateTitle(indexOf(document));
+    });
+    connect(document, &Document::filePathChanged, this, [this, document](const QString &filePath) {
+        const int index = indexOf(document);
+        if (index < 0) return;
+        unwatch(m_tabs[index].filePath);
+        m_tabs[index].filePath = filePath;
+        watch(filePath);
+        updateTitle(index);
+    });
+    connect(document, &Document::changedOnDisk, this, [this, document]() {
+        const int index = indexOf(document);
+        if (index < 0) return;
+        const QString name = m_tabBar->tabText(index).remove(QLatin1Char('*'));
+        const auto answer = QMessageBox::question(this, tr("Cambios en disco"),
+            tr("%1 cambió en disco. ¿Recargarlo y descartar los cambios sin guardar?").arg(name));
+        if (answer == QMessageBox::Yes) document->reloadFromDisk(true);
+    });
+    watch(tab.filePath);
+    if (!tab.filePath.isEmpty()) {
+        const QString absolute = QFileInfo(tab.filePath).absoluteFilePath();
+        for (auto it = m_diagnostics.cbegin(); it != m_diagnostics.cend(); ++it) {
+            if (it->contains(absolute)) document->setDiagnostics(it.key(), it->value(absolute));
+        }
+    }
+    tab.document = document;
+    return document;
+}
+
+// Una pestaña limpia se puede releer del disco; una modificada guarda su
+// texto comprimido. El historial de deshacer no sobrevive a la descarga.
+void DocumentTabs::unload(Tab &tab) {
+    Document *document = tab.document;
+    if (!document) return;
+    if (document->isModified())
+        tab.compressed = qCompress(document->textDocument()->toPlainText().toUtf8());
+    tab.tokens = document->tokenCache();
+    document->setLanguageClient(nullptr);
+    unwatch(document->filePath());
+    tab.document = nullptr;
+    delete document;
+}
+
+// Descarga las pestañas inactivas usadas hace más tiempo hasta entrar en el presupuesto
+void DocumentTabs::enforceBudget() {
+    qint64 total = 0;
+    for (const Tab &tab : std::as_const(m_tabs)) {
+        if (tab.document) total += tab.document->memoryCost();
+    }
+    while (total > m_budget) {
+        int victim = -1;
+        for (int i = 0; i < m_tabs.size(); ++i) {
+            const Tab &tab = m_tabs[i];
+            // Un log en seguimiento se descargaría y perdería su posición
+            if (!tab.document || isShown(tab.document) || tab.document->isTailing()) continue;
+            if (victim < 0 || tab.lastUsed < m_tabs[victim].lastUsed) victim = i;
+        }
+        if (victim < 0) break;
+        total -= m_tabs[victim].document->memoryCost();
+        unload(m_tabs[victim]);
+    }
+}
+
+// ---------- Diagnósticos ----------
+
+void DocumentTabs::addDiagnostics(const QString &source, const QVector<Diagnostic> &diagnostics) {
+    QHash<QString, QVector<Diagnostic>> &byFile = m_diagnostics[source];
+    QSet<QString> touched;
+    for (const Diagnostic &d : diagnostics) {
+        const QString absolute = QFileInfo(d.file).absoluteFilePath();
+        byFile[absolute].append(d);
+        touched.insert(absolute);
+    }
+    for (const Tab &tab : std::as_const(m_tabs)) {
+        if (!tab.document || tab.filePath.isEmpty()) continue;
+        const QString absolute = QFileInfo(tab.filePath).absoluteFilePath();
+        if (touched.contains(absolute)) tab.document->setDiagnostics(source, byFile.value(absolute));
+    }
+}
+
+void DocumentTabs::clearDiagnostics(const QString &source) {
+    m_diagnostics.remove(source);
+    for (const Tab &tab : std::as_const(m_tabs)) {
+        if (tab.document) tab.document->setDiagnostics(source, {});
+    }
+}
+
+// ---------- Cambios externos ----------
+// Solo se vigilan los documentos cargados: una pestaña descargada y limpia
+// ya se relee del disco al volver a activarla
+
+void DocumentTabs::watch(const QString &filePath) {
+    if (!filePath.isEmpty()) m_watcher->addPath(filePath);
+}
+
+void DocumentTabs::unwatch(const QString &filePath) {
+    if (!filePath.isEmpty()) m_watcher->removePath(filePath);
+}
+
+void DocumentTabs::reloadChangedFiles() {
+    const QSet<QString> changed = std::exchange(m_changedFiles, {});
+    for (const QString &path : changed) {
+        const QString absolute = QFileInfo(path).absoluteFilePath();
+        for (const Tab &tab : std::as_const(m_tabs)) {
+            if (!tab.document || tab.filePath.isEmpty() || QFileInfo(tab.filePath).absoluteFilePath() != absolute)
+                continue;
+            // Quien guarda con renombrado atómico reemplaza el fichero y el
+            // watcher lo pierde de vista
+            if (!m_watcher->files().contains(path) && QFileInfo::exists(path)) m_watcher->addPath(path);
+            if (tab.document->isTailing()) tab.document->readTail();
+            else tab.document->reloadFromDisk();
+        }
+    }
+}
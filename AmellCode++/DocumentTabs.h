@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QSet>
+#include <QWidget>
+
+#include "Document.h"
+#include "Editor.h"
+
+class LspClient;
+class QFileSystemWatcher;
+class QSplitter;
+class QTabBar;
+class QTimer;
+
+// Pestañas de documentos sobre uno o dos Editor (vista dividida). Las vistas
+// de un mismo fichero comparten el Document: texto, resaltado y tokens se
+// calculan una vez y cada vista guarda solo cursor, scroll y zoom. Solo las pestañas usadas
+// recientemente mantienen su QTextDocument: por encima del presupuesto de
+// memoria las inactivas se descargan (las limpias se releen del disco, las
+// modificadas se guardan comprimidas) conservando cursor, scroll, pliegues
+// y tokens semánticos para que reactivarlas sea inmediato. Los ficheros de
+// las pestañas cargadas se vigilan y se recargan por diferencias.
+class DocumentTabs : public QWidget {
+    Q_OBJECT
+public:
+    explicit DocumentTabs(QWidget *parent = nullptr);
+    ~DocumentTabs() override;
+
+    // Vista activa (la última que tuvo el foco)
+    Editor *editor() const { return m_editor; }
+    Document *currentDocument() const;
+    int currentIndex() const { return m_current; }
+    void setLanguageClient(LspClient *client);
+
+    void newDocument();
+    // Si el fichero ya está abierto solo se activa su pestaña
+    void openFile(const QString &filePath);
+    void save();
+    // Pregunta antes de descartar cambios; false si el usuario cancela
+    bool closeTab(int index);
+    bool closeAll();
+
+    void setMemoryBudget(qint64 bytes);
+
+    // Diagnósticos ajenos a clangd (compilador) por fichero; también se
+    // aplican a las pestañas que se carguen más tarde
+    void addDiagnostics(const QString &source, const QVector<Diagnostic> &diagnostics);
+    void clearDiagnostics(const QString &source);
+
+    // Abre una segunda vista del documento actual, lado a lado o debajo
+    void split(Qt::Orientation orientation);
+    void unsplit();
+
+    static constexpr qint64 DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+signals:
+    // Cambio de pestaña o de vista activa con otro documento
+    void currentDocumentChanged(Document *document);
+
+private slots:
+    void onCurrentChanged(int index);
+    void onTabMoved(int from, int to);
+    void reloadChangedFiles();
+
+private:
+    struct Tab {
+        QString filePath;
+        QString untitledName;
+        Document *document = nullptr;     // nulo mientras está descargada
+        QByteArray compressed;            // texto de una pestaña modificada y descargada
+        Editor::ViewState view;
+        Document::TokenCache tokens;
+        qint64 lastUsed = 0;
+    };
+
+    Editor *createView(Document *document);
+    void setActiveView(Editor *view);
+    void syncZoom(Editor *source);
+    bool isShown(const Document *document) const;
+
+    int addTab(Tab tab);
+    Document *load(Tab &tab);
+    void unload(Tab &tab);
+    void enforceBudget();
+    void updateTitle(int index);
+    int indexOf(const Document *document) const;
+    bool isModified(const Tab &tab) const;
+    void watch(const QString &filePath);
+    void unwatch(const QString &filePath);
+
+    QTabBar *m_tabBar;
+    QSplitter *m_splitter;
+    QList<Editor *> m_views;
+    Editor *m_editor;
+    QVector<Tab> m_tabs;              // mismo orden que m_tabBar
+    int m_current = -1;
+    int m_untitledCount = 0;
+    qint64 m_useCounter = 0;
+    qint64 m_budget = DEFAULT_BUDGET;
+    LspClient *m_lspClient = nullptr;
+
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_reloadTimer;            // agrupa los avisos que llegan en cada intervalo
+    QSet<QString> m_changedFiles;
+
+    QHash<QString, QHash<QString, QVector<Diagnostic>>> m_diagnostics;   // fuente → fichero absoluto
+};
@@ -1,69 +1,200 @@
 #include "Editor.h"
 #include "CppHighlighter.h"
+#include "CompletionIndex.h"
+#include "BlockData.h"
+#include "Document.h"
+#include "LspClient.h"
+#include "Minimap.h"
+#include "UndoHistory.h"
 
+#include <QAbstractItemView>
+#include <QCompleter>
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QFontMetricsF>
+#include <QHelpEvent>
+#include <QScrollBar>
+#include <QSettings>
+#include <QStringListModel>
+#include <QTimer>
+#include <QToolTip>
 #include <QPainter>
 #include <QTextBlock>
-#include <QFile>
 #include <QFileDialog>
 #include <QDir>
 #include <QTextFormat>
+#include <QTextOption>
 #include <QWheelEvent>
 #include <QKeyEvent>
+#include <QMouseEvent>
+#include <QContextMenuEvent>
+#include <QDropEvent>
+#include <QInputMethodEvent>
+#include <QTextLayout>
+#include <QMimeData>
 
-Editor::Editor(QWidget *parent)
+#include <algorithm>
+
+Editor::Editor(Document *document, QWidget *parent)
     : QPlainTextEdit(parent),
       m_lineNumberArea(new LineNumberArea(this)),
-      m_highlighter(new CppHighlighter(document())) {
+      m_minimap(new Minimap(this)),
+      m_completer(nullptr),
+      m_completionModel(new QStringListModel(this)),
+      m_semanticTimer(new QTimer(this)) {
 
     connect(this, &Editor::blockCountChanged, this, &Editor::updateLineNumberAreaWidth);
     connect(this, &Editor::updateRequest, this, &Editor::updateLineNumberArea);
     connect(this, &Editor::cursorPositionChanged, this, &Editor::highlightCurrentLine);
+    connect(this, &Editor::cursorPositionChanged, this, &Editor::revealCursorBlock);
+    connect(this, &Editor::cursorPositionChanged, this, [this]() {
+        followLongLine(textCursor().positionInBlock());
+    });
+    connect(horizontalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+        const QTextCursor shown = cursorForPosition(QPoint(viewport()->width() / 2, cursorRect().center().y()));
+        if (shown.block() == textCursor().block()) followLongLine(shown.positionInBlock());
+    });
 
-    updateLineNumberAreaWidth(0);
-    highlightCurrentLine();
-    setTabStopDistance(fontMetrics().horizontalAdvance(" ") * 4);
+    // Autocompletado: el modelo se rellena a mano con los candidatos de CompletionIndex
+    m_completer = new QCompleter(m_completionModel, this);
+    m_completer->setWidget(this);
+    m_completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    m_completer->setCaseSensitivity(Qt::CaseSensitive);
+    connect(m_completer, QOverload<const QString &>::of(&QCompleter::activated),
+            this, &Editor::insertCompletion);
+
+    // Tokens semánticos: se piden tras una pausa y solo para el área visible
+    m_semanticTimer->setSingleShot(true);
+    m_semanticTimer->setInterval(250);
+    connect(m_semanticTimer, &QTimer::timeout, this, &Editor::requestSemanticTokens);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, m_semanticTimer, QOverload<>::of(&QTimer::start));
+
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, m_minimap, QOverload<>::of(&QWidget::update));
+
+    // Las selecciones de los cursores extra solo se generan para la zona visible
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+        if (!m_extraCursors.isEmpty()) highlightCurrentLine();
+    });
+
+    m_basePointSize = font().pointSizeF();
+    showDocument(document);
 }
 
-void Editor::newDocument() {
-    setPlainText("");
-    m_currentFile.clear();
+Editor::~Editor() {
+    for (const QMetaObject::Connection &c : std::as_const(m_documentConnections)) disconnect(c);
+    if (m_document) m_document->removeView();
+}
 
-    if (m_zoomLevel != 0) {
-        if (m_zoomLevel > 0) for (int i = 0; i < m_zoomLevel; ++i) zoomOut(1);
-        else for (int i = 0; i < -m_zoomLevel; ++i) zoomIn(1);
+// Cambia el documento mostrado sin copiar nada: el texto, el resaltado y el
+// historial viven en Document; la vista solo guarda cursor, scroll y zoom
+void Editor::showDocument(Document *document, const ViewState &state) {
+    for (const QMetaObject::Connection &c : std::as_const(m_documentConnections)) disconnect(c);
+    m_documentConnections.clear();
+    if (m_document && m_document->languageClient()) m_document->languageClient()->cancel(m_semanticRequest);
+    m_semanticRequest = 0;
+    m_extraCursors.clear();
+    if (m_document) m_document->removeView();
 
-        m_zoomLevel = 0;
-        emit zoomLevelChanged(m_zoomLevel);
+    m_document = document;
+    setDocument(document->textDocument());
+    // Qt guarda la fuente en el QTextDocument: si otra vista ya lo muestra,
+    // esta adopta su zoom en vez de imponer el suyo
+    if (document->viewCount() > 0)
+        followZoomLevel(qRound(document->textDocument()->defaultFont().pointSizeF() - m_basePointSize));
+    else
+        applyDocumentFont();
+    m_minimap->setDocument(document);
+    m_documentConnections << connect(document->textDocument(), &QTextDocument::contentsChange, this, &Editor::onContentsChange)
+                          << connect(document, &Document::diagnosticsChanged, this, &Editor::rebuildDiagnosticSelections)
+                          << connect(document, &Document::viewCountChanged, this, &Editor::updateWrapMode)
+                          << connect(document, &Document::longLinesDetected, this, &Editor::updateWrapMode)
+                          << connect(document, &Document::aboutToReload, this, [this]() {
+        // Un cursor en la primera línea visible se desplaza con las ediciones de la recarga
+        m_scrollAnchor = QTextCursor(document());
+        m_scrollAnchor.setPosition(firstVisibleBlock().position());
+    })
+                          << connect(document, &Document::reloaded, this, [this]() {
+        scrollToLine(m_scrollAnchor.blockNumber());
+        m_scrollAnchor = QTextCursor();
+    })
+                          << connect(document, &Document::tailModeChanged, this, [this](bool enabled) {
+        setReadOnly(enabled);
+        if (enabled) verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    })
+                          << connect(document, &Document::tailAboutToAppend, this, [this]() {
+        m_pinnedToEnd = verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+    })
+                          << connect(document, &Document::tailAppended, this, [this]() {
+        // Pegada al final mientras el usuario no suba a leer
+        if (m_pinnedToEnd) verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    });
+    setReadOnly(document->isTailing());
+    document->addView();
+    updateLineNumberAreaWidth(0);
+
+    if (state.valid) {
+        setFolded(state.folded, true);
+        const int maxPos = document->textDocument()->characterCount() - 1;
+        QTextCursor c(document->textDocument());
+        c.setPosition(qBound(0, state.anchor, maxPos));
+        c.setPosition(qBound(0, state.position, maxPos), QTextCursor::KeepAnchor);
+        setTextCursor(c);
+        verticalScrollBar()->setValue(state.verticalScroll);
+        horizontalScrollBar()->setValue(state.horizontalScroll);
+    } else {
+        restoreFoldState();
     }
+    rebuildDiagnosticSelections();
+    m_semanticTimer->start();
 }
 
-void Editor::openFile(const QString &filePath) {
-    QFile f(filePath);
-    if (f.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        setPlainText(QString::fromUtf8(f.readAll()));
-        m_currentFile = filePath;
+// Las vistas de un mismo documento comparten el QPlainTextDocumentLayout,
+// que solo tiene un ancho: con varias se desactiva el ajuste de línea. Con
+// líneas largas también, para no recalcular su ajuste en cada redimensionado
+void Editor::updateWrapMode() {
+    const bool noWrap = m_document->viewCount() > 1 || m_document->hasLongLines();
+    setLineWrapMode(noWrap ? QPlainTextEdit::NoWrap : QPlainTextEdit::WidgetWidth);
+}
 
-        if (m_zoomLevel != 0) {
-            if (m_zoomLevel > 0) for (int i = 0; i < m_zoomLevel; ++i) zoomOut(1);
-            else for (int i = 0; i < -m_zoomLevel; ++i) zoomIn(1);
+// Desplaza la ventana resaltada de la línea larga del cursor cuando la
+// columna mostrada se acerca a su borde
+void Editor::followLongLine(int column) {
+    QTextBlock block = textCursor().block();
+    if (!BlockData::isLong(block)) return;
+    BlockData *data = BlockData::ensure(block);
+    const int margin = BlockData::HIGHLIGHT_WINDOW / 8;
+    if (column >= data->highlightStart + margin
+        && column < data->highlightStart + BlockData::HIGHLIGHT_WINDOW - margin) return;
+    const int start = qMax(0, column - BlockData::HIGHLIGHT_WINDOW / 2);
+    if (start == data->highlightStart) return;
+    data->highlightStart = start;
+    m_document->highlighter()->rehighlightBlock(block);
+}
 
-            m_zoomLevel = 0;
-            emit zoomLevelChanged(m_zoomLevel);
-        }
-    }
+Editor::ViewState Editor::viewState() const {
+    ViewState state;
+    state.valid = true;
+    state.anchor = textCursor().anchor();
+    state.position = textCursor().position();
+    state.verticalScroll = verticalScrollBar()->value();
+    state.horizontalScroll = horizontalScrollBar()->value();
+    state.folded = foldedBlocks();
+    return state;
 }
 
-void Editor::save() {
-    QString path = m_currentFile;
+QString Editor::currentFile() const {
+    return m_document->filePath();
+}
+
+bool Editor::save() {
+    QString path = m_document->filePath();
     if (path.isEmpty()) {
         path = QFileDialog::getSaveFileName(this, tr("Save File"), QDir::currentPath());
-        if (path.isEmpty()) return;
-        m_currentFile = path;
-    }
-    QFile f(path);
-    if (f.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        f.write(toPlainText().toUtf8());
+        if (path.isEmpty()) return false;
     }
+    if (!m_document->save(path)) return false;
+    saveFoldState();
+    return true;
 }
 
 int Editor::lineNumberAreaWidth() const {
@@ -74,11 +205,15 @@ int Editor::lineNumberAreaWidth() const {
         ++digits;
     }
     int space = 3 + fontMetrics().horizontalAdvance(QLatin1Char('9')) * digits;
-    return space + 6;
+    return space + 6 + foldMarkerWidth();
+}
+
+int Editor::foldMarkerWidth() const {
+    return fontMetrics().height();
 }
 
 void Editor::updateLineNumberAreaWidth(int) {
-    setViewportMargins(lineNumberAreaWidth(), 0, 0, 0);
+    setViewportMargins(lineNumberAreaWidth(), 0, Minimap::WIDTH, 0);
 }
 
 void Editor::updateLineNumberArea(const QRect &rect, int dy) {
@@ -93,8 +228,40 @@ void Editor::updateLineNumberArea(const QRect &rect, int dy) {
 
 void Editor::resizeEvent(QResizeEvent *e) {
     QPlainTextEdit::resizeEvent(e);
+    updateSideAreas();
+}
+
+// Coloca el gutter y el minimapa a los lados del viewport
+void Editor::updateSideAreas() {
+    updateLineNumberAreaWidth(0);
     QRect cr = contentsRect();
     m_lineNumberArea->setGeometry(QRect(cr.left(), cr.top(), lineNumberAreaWidth(), cr.height()));
+    const QRect vr = viewport()->geometry();
+    m_minimap->setGeometry(QRect(vr.right() + 1, vr.top(), Minimap::WIDTH, vr.height()));
+}
+
+int Editor::firstVisibleLine() const {
+    return firstVisibleBlock().blockNumber();
+}
+
+int Editor::visibleLineCount() const {
+    const int last = cursorForPosition(QPoint(0, viewport()->height() - 1)).blockNumber();
+    return qMax(1, last - firstVisibleLine() + 1);
+}
+
+void Editor::goToLine(int line, int column) {
+    const QTextBlock block = document()->findBlockByNumber(qBound(0, line, blockCount() - 1));
+    QTextCursor c(block);
+    c.setPosition(block.position() + qBound(0, column, block.length() - 1));
+    setTextCursor(c);
+    centerCursor();
+    setFocus();
+}
+
+// El valor de la barra cuenta líneas visuales (sin las plegadas), no bloques
+void Editor::scrollToLine(int blockNumber) {
+    const QTextBlock block = document()->findBlockByNumber(qBound(0, blockNumber, blockCount() - 1));
+    verticalScrollBar()->setValue(block.firstLineNumber());
 }
 
 void Editor::lineNumberAreaPaintEvent(QPaintEvent *event) {
@@ -106,11 +273,38 @@ void Editor::lineNumberAreaPaintEvent(QPaintEvent *event) {
     int top = static_cast<int>(blockBoundingGeometry(block).translated(contentOffset()).top());
     int bottom = top + static_cast<int>(blockBoundingRect(block).height());
 
+    const int markerSize = foldMarkerWidth();
+    const int markerLeft = m_lineNumberArea->width() - markerSize;
+
+    painter.setRenderHint(QPainter::Antialiasing);
     while (block.isValid() && top <= event->rect().bottom()) {
         if (block.isVisible() && bottom >= event->rect().top()) {
             QString number = QString::number(blockNumber + 1);
             painter.setPen(QColor(140, 170, 210));
-            painter.drawText(0, top, m_lineNumberArea->width() - 8, fontMetrics().height(), Qt::AlignRight, number);
+            painter.drawText(0, top, markerLeft - 4, fontMetrics().height(), Qt::AlignRight, number);
+
+            // ---------- Marcador de diagnóstico ----------
+            const auto severity = m_diagnosticLines.constFind(blockNumber);
+            if (severity != m_diagnosticLines.cend()) {
+                const QColor color = *severity == Diagnostic::Error ? QColor("#E06C75")
+                                   : *severity == Diagnostic::Warning ? QColor("#E5C07B") : QColor("#61AFEF");
+                painter.fillRect(QRect(0, top, 3, fontMetrics().height()), color);
+            }
+
+            // ---------- Marcador de plegado (▾ abierto, ▸ cerrado) ----------
+            const QPair<int, int> range = foldRange(block);
+            if (range.second >= range.first) {
+                const BlockData *data = BlockData::of(block);
+                const bool folded = data && data->folded;
+                const qreal cx = markerLeft + markerSize / 2.0;
+                const qreal cy = top + fontMetrics().height() / 2.0;
+                const qreal r = markerSize / 4.0;
+                const QPointF open[3] = { {cx - r, cy - r / 2}, {cx + r, cy - r / 2}, {cx, cy + r / 2} };
+                const QPointF closed[3] = { {cx - r / 2, cy - r}, {cx - r / 2, cy + r}, {cx + r / 2, cy} };
+                painter.setPen(Qt::NoPen);
+                painter.setBrush(folded ? QColor(229, 192, 123) : QColor(140, 170, 210));
+                painter.drawPolygon(folded ? closed : open, 3);
+            }
         }
 
         block = block.next();
@@ -120,6 +314,142 @@ void Editor::lineNumberAreaPaintEvent(QPaintEvent *event) {
     }
 }
 
+void Editor::lineNumberAreaMousePressEvent(QMouseEvent *event) {
+    if (event->position().x() < m_lineNumberArea->width() - foldMarkerWidth()) return;
+    const QTextBlock block = cursorForPosition(QPoint(0, static_cast<int>(event->position().y()))).block();
+    if (block.isValid()) toggleFold(block.blockNumber());
+}
+
+// Bloques que oculta el pliegue que empieza en 'block' como {primero, último}.
+// Llaves y #if dejan visible la línea de cierre; los comentarios /* */ se ocultan enteros.
+QPair<int, int> Editor::foldRange(const QTextBlock &block) const {
+    const int n = block.blockNumber();
+    const int end = m_document->highlighter()->brackets().foldEnd(document(), n);
+    if (end > n) return {n + 1, end - 1};
+
+    if (block.userState() == 1 && block.previous().userState() != 1) {
+        QTextBlock b = block.next();
+        while (b.isValid() && b.userState() == 1) b = b.next();
+        return {n + 1, b.isValid() ? b.blockNumber() : document()->blockCount() - 1};
+    }
+    return {n + 1, n};
+}
+
+void Editor::toggleFold(int blockNumber) {
+    const QTextBlock block = document()->findBlockByNumber(blockNumber);
+    if (!block.isValid()) return;
+    const BlockData *data = BlockData::of(block);
+    setFolded({blockNumber}, !(data && data->folded));
+}
+
+// Cambia la visibilidad de todos los bloques afectados y marca el rango sucio
+// una sola vez: QPlainTextDocumentLayout rehace solo ese tramo y perezosamente.
+void Editor::setFolded(const QList<int> &startBlocks, bool fold) {
+    int dirtyFrom = -1;
+    int dirtyTo = -1;
+
+    for (int n : startBlocks) {
+        QTextBlock start = document()->findBlockByNumber(n);
+        if (!start.isValid()) continue;
+        const QPair<int, int> range = foldRange(start);
+        if (range.second < range.first) continue;
+        BlockData *data = BlockData::ensure(start);
+        if (data->folded == fold) continue;
+        data->folded = fold;
+
+        QTextBlock b = start.next();
+        QTextBlock last = b;
+        while (b.isValid() && b.blockNumber() <= range.second) {
+            b.setVisible(!fold);
+            last = b;
+            const BlockData *inner = BlockData::of(b);
+            if (!fold && inner && inner->folded) {
+                // Los pliegues anidados siguen cerrados
+                const int innerEnd = foldRange(b).second;
+                if (innerEnd > b.blockNumber()) {
+                    last = document()->findBlockByNumber(qMin(innerEnd, range.second));
+                    b = last.next();
+                    continue;
+                }
+            }
+            b = b.next();
+        }
+
+        const int from = start.position();
+        const int to = last.position() + last.length();
+        dirtyFrom = dirtyFrom < 0 ? from : qMin(dirtyFrom, from);
+        dirtyTo = qMax(dirtyTo, to);
+    }
+    if (dirtyFrom < 0) return;
+
+    // El layout recalcula las líneas visibles y avisa él mismo del nuevo
+    // tamaño (barra de desplazamiento incluida)
+    document()->markContentsDirty(dirtyFrom, dirtyTo - dirtyFrom);
+
+    if (!textCursor().block().isVisible()) {
+        QTextCursor c = textCursor();
+        while (c.block().isValid() && !c.block().isVisible())
+            c.setPosition(c.block().previous().position());
+        c.movePosition(QTextCursor::EndOfBlock);
+        setTextCursor(c);
+    }
+    viewport()->update();
+    m_lineNumberArea->update();
+    saveFoldState();
+}
+
+// Si el cursor acaba dentro de un pliegue (búsqueda, ir a línea...) se abren
+// los pliegues que lo contienen, del más interno al más externo
+void Editor::revealCursorBlock() {
+    QTextBlock block = textCursor().block();
+    if (block.isVisible()) return;
+
+    QList<int> starts;
+    for (QTextBlock b = block.previous(); b.isValid(); b = b.previous()) {
+        const BlockData *data = BlockData::of(b);
+        if (data && data->folded && foldRange(b).second >= block.blockNumber())
+            starts.append(b.blockNumber());
+        if (b.isVisible()) break;
+    }
+    setFolded(starts, false);
+
+    if (!block.isVisible()) {
+        block.setVisible(true);
+        document()->markContentsDirty(block.position(), block.length());
+    }
+}
+
+static QString foldSettingsKey(const QString &filePath) {
+    const QByteArray path = QFileInfo(filePath).absoluteFilePath().toUtf8();
+    return QStringLiteral("folds/") + QString::fromLatin1(QCryptographicHash::hash(path, QCryptographicHash::Md5).toHex());
+}
+
+QList<int> Editor::foldedBlocks() const {
+    QList<int> blocks;
+    for (QTextBlock b = document()->begin(); b.isValid(); b = b.next()) {
+        const BlockData *data = BlockData::of(b);
+        if (data && data->folded) blocks.append(b.blockNumber());
+    }
+    return blocks;
+}
+
+void Editor::saveFoldState() const {
+    if (m_document->filePath().isEmpty()) return;
+    QStringList lines;
+    for (int n : foldedBlocks()) lines.append(QString::number(n));
+    QSettings settings;
+    if (lines.isEmpty()) settings.remove(foldSettingsKey(m_document->filePath()));
+    else settings.setValue(foldSettingsKey(m_document->filePath()), lines);
+}
+
+void Editor::restoreFoldState() {
+    if (m_document->filePath().isEmpty()) return;
+    const QStringList lines = QSettings().value(foldSettingsKey(m_document->filePath())).toStringList();
+    QList<int> starts;
+    for (const QString &l : lines) starts.append(l.toInt());
+    setFolded(starts, true);
+}
+
 void Editor::highlightCurrentLine() {
     QList<QTextEdit::ExtraSelection> extraSelections;
 
@@ -133,44 +463,704 @@ void Editor::highlightCurrentLine() {
         extraSelections.append(selection);
     }
 
+    // ---------- Corchete emparejado (bajo o justo antes del cursor) ----------
+    const BracketIndex &brackets = m_document->highlighter()->brackets();
+    const int pos = textCursor().position();
+    int at = pos;
+    int match = brackets.matchBracket(document(), at);
+    if (match < 0 && pos > 0) {
+        at = pos - 1;
+        match = brackets.matchBracket(document(), at);
+    }
+    if (match >= 0) {
+        for (int p : {at, match}) {
+            QTextEdit::ExtraSelection selection;
+            selection.format.setBackground(QColor(97, 175, 239, 90));
+            selection.cursor = QTextCursor(document());
+            selection.cursor.setPosition(p);
+            selection.cursor.setPosition(p + 1, QTextCursor::KeepAnchor);
+            extraSelections.append(selection);
+        }
+    }
+
+    // ---------- Selecciones de los cursores extra visibles ----------
+    if (!m_extraCursors.isEmpty()) {
+        const int first = firstVisibleBlock().position();
+        const QTextBlock lastBlock = cursorForPosition(QPoint(viewport()->width(), viewport()->height())).block();
+        const int last = lastBlock.position() + lastBlock.length();
+        auto it = std::lower_bound(m_extraCursors.cbegin(), m_extraCursors.cend(), first,
+                                   [](const CursorRange &c, int pos) { return c.position < pos; });
+        for (; it != m_extraCursors.cend() && it->position <= last; ++it) {
+            if (it->anchor == it->position) continue;
+            QTextEdit::ExtraSelection selection;
+            selection.format.setBackground(QColor(30, 90, 170));
+            selection.cursor = QTextCursor(document());
+            selection.cursor.setPosition(it->anchor);
+            selection.cursor.setPosition(it->position, QTextCursor::KeepAnchor);
+            extraSelections.append(selection);
+        }
+    }
+
+    extraSelections.append(m_diagnosticSelections);
     setExtraSelections(extraSelections);
 }
 
+void Editor::setDiagnostics(const QString &source, const QVector<Diagnostic> &diagnostics) {
+    m_document->setDiagnostics(source, diagnostics);
+}
+
+// Los QTextCursor de las selecciones siguen las ediciones por sí solos,
+// así que solo se reconstruyen cuando llegan diagnósticos nuevos
+void Editor::rebuildDiagnosticSelections() {
+    m_diagnosticSelections.clear();
+    m_diagnosticMessages.clear();
+    m_diagnosticLines.clear();
+
+    const QHash<QString, QVector<Diagnostic>> &diagnostics = m_document->diagnostics();
+    for (auto it = diagnostics.cbegin(); it != diagnostics.cend(); ++it) {
+        for (const Diagnostic &d : it.value()) {
+            const QTextBlock block = document()->findBlockByNumber(d.line);
+            if (!block.isValid()) continue;
+
+            QTextCursor cursor(document());
+            cursor.setPosition(block.position() + qMin(d.column, block.length() - 1));
+            const QTextBlock endBlock = document()->findBlockByNumber(d.endLine);
+            if (d.endLine >= 0 && endBlock.isValid()) {
+                const int endPos = endBlock.position() + qMin(d.endColumn, endBlock.length() - 1);
+                if (endPos > cursor.position())
+                    cursor.setPosition(endPos, QTextCursor::KeepAnchor);
+            }
+            if (!cursor.hasSelection()) {
+                cursor.movePosition(QTextCursor::EndOfWord, QTextCursor::KeepAnchor);
+                if (!cursor.hasSelection()) cursor.movePosition(QTextCursor::Right, QTextCursor::KeepAnchor);
+            }
+
+            QTextEdit::ExtraSelection selection;
+            selection.cursor = cursor;
+            selection.format.setUnderlineStyle(QTextCharFormat::WaveUnderline);
+            selection.format.setUnderlineColor(d.severity == Diagnostic::Error ? QColor("#E06C75")
+                                               : d.severity == Diagnostic::Warning ? QColor("#E5C07B")
+                                               : QColor("#61AFEF"));
+            m_diagnosticSelections.append(selection);
+            m_diagnosticMessages.append(d.source.isEmpty() ? d.message : d.source + ": " + d.message);
+            const auto worst = m_diagnosticLines.constFind(d.line);
+            if (worst == m_diagnosticLines.cend() || d.severity < *worst) m_diagnosticLines.insert(d.line, d.severity);
+        }
+    }
+    highlightCurrentLine();
+    m_lineNumberArea->update();
+}
+
+bool Editor::event(QEvent *event) {
+    if (event->type() == QEvent::ToolTip) {
+        auto *help = static_cast<QHelpEvent *>(event);
+        const int pos = cursorForPosition(help->pos() - viewport()->pos()).position();
+        QStringList messages;
+        for (int i = 0; i < m_diagnosticSelections.size(); ++i) {
+            const QTextCursor &c = m_diagnosticSelections[i].cursor;
+            if (pos >= c.selectionStart() && pos <= c.selectionEnd())
+                messages.append(m_diagnosticMessages[i]);
+        }
+        if (messages.isEmpty()) QToolTip::hideText();
+        else QToolTip::showText(help->globalPos(), messages.join('\n'), this);
+        return true;
+    }
+    return QPlainTextEdit::event(event);
+}
+
 void Editor::wheelEvent(QWheelEvent *event) {
     if (event->modifiers() & Qt::ControlModifier) {
         int delta = event->angleDelta().y();
         int steps = delta / 120;
         if (steps == 0) steps = (delta > 0) ? 1 : -1;
+        setZoomLevel(m_zoomLevel + steps);
+        event->accept();
+        return;
+    }
+
+    QPlainTextEdit::wheelEvent(event);
+}
 
-        int allowedSteps = steps;
-        int newZoom = m_zoomLevel + steps;
-        if (newZoom > MAX_ZOOM) allowedSteps = MAX_ZOOM - m_zoomLevel;
-        if (newZoom < MIN_ZOOM) allowedSteps = MIN_ZOOM - m_zoomLevel;
+// Un único cambio de fuente por salto de zoom: cada zoomIn(1) invalidaba el
+// layout de todo el documento. QPlainTextDocumentLayout solo limpia los
+// bloques y el pintado vuelve a maquetar los visibles; el resto se maqueta
+// cuando se muestra. Gutter, tabulador y minimapa se ajustan en el mismo paso.
+// La fuente y las opciones de texto son del QTextDocument, no de la vista:
+// hay que ponerlas cada vez que se muestra otro documento, y solo si cambian
+void Editor::applyDocumentFont() {
+    applyTabStop(font());
+    if (document()->defaultFont() != font()) document()->setDefaultFont(font());
+}
 
-        if (allowedSteps > 0) for (int i = 0; i < allowedSteps; ++i) zoomIn(1);
-        else if (allowedSteps < 0) for (int i = 0; i < -allowedSteps; ++i) zoomOut(1);
+// El tabulador va antes que la fuente: los dos marcan el layout como sucio,
+// pero nada se vuelve a maquetar hasta el siguiente pintado
+void Editor::applyTabStop(const QFont &font) {
+    QTextDocument *doc = document();
+    QTextOption option = doc->defaultTextOption();
+    const qreal distance = QFontMetricsF(font).horizontalAdvance(QLatin1Char(' ')) * 4;
+    if (qFuzzyCompare(option.tabStopDistance(), distance)) return;
+    option.setTabStopDistance(distance);
+    doc->setDefaultTextOption(option);
+}
 
-        m_zoomLevel += allowedSteps;
-        emit zoomLevelChanged(m_zoomLevel);
-        event->accept();
+// QPlainTextEdit copia la fuente al documento en cada FontChange aunque ya
+// sea la misma, y eso invalida el layout entero
+void Editor::changeEvent(QEvent *event) {
+    if (event->type() == QEvent::FontChange && document()->defaultFont() == font()) {
+        QAbstractScrollArea::changeEvent(event);
         return;
     }
+    QPlainTextEdit::changeEvent(event);
+}
 
-    QPlainTextEdit::wheelEvent(event);
+void Editor::setZoomLevel(int level) {
+    level = qBound(MIN_ZOOM, level, MAX_ZOOM);
+    if (level == m_zoomLevel) return;
+    m_zoomLevel = level;
+    applyZoom();
+    emit zoomLevelChanged(m_zoomLevel);
+}
+
+void Editor::followZoomLevel(int level) {
+    level = qBound(MIN_ZOOM, level, MAX_ZOOM);
+    if (level == m_zoomLevel) return;
+    m_zoomLevel = level;
+    applyZoom();
+}
+
+void Editor::applyZoom() {
+    const int first = firstVisibleLine();
+    QFont f = font();
+    f.setPointSizeF(qMax(1.0, m_basePointSize + m_zoomLevel));
+    applyTabStop(f);
+    setFont(f);
+    updateSideAreas();
+    scrollToLine(first);
 }
 
 void Editor::keyPressEvent(QKeyEvent *event) {
+    // Con el popup abierto, estas teclas las resuelve el QCompleter
+    if (m_completer->popup()->isVisible()) {
+        switch (event->key()) {
+        case Qt::Key_Enter:
+        case Qt::Key_Return:
+        case Qt::Key_Escape:
+        case Qt::Key_Tab:
+        case Qt::Key_Backtab:
+            event->ignore();
+            return;
+        default:
+            break;
+        }
+    }
+
     if ((event->modifiers() & Qt::ControlModifier) && event->key() == Qt::Key_0) {
-        if (m_zoomLevel != 0) {
-            if (m_zoomLevel > 0) for (int i = 0; i < m_zoomLevel; ++i) zoomOut(1);
-            else for (int i = 0; i < -m_zoomLevel; ++i) zoomIn(1);
+        setZoomLevel(0);
+        event->accept();
+        return;
+    }
+
+    if (event->matches(QKeySequence::Undo)) {
+        undo();
+        event->accept();
+        return;
+    }
+    if (event->matches(QKeySequence::Redo)) {
+        redo();
+        event->accept();
+        return;
+    }
+
+    // ---------- Multicursor ----------
+    const Qt::KeyboardModifiers mods = event->modifiers();
+    if (mods == Qt::ControlModifier && event->key() == Qt::Key_D) {
+        addNextOccurrence();
+        event->accept();
+        return;
+    }
+    if (mods == (Qt::AltModifier | Qt::ShiftModifier) && (event->key() == Qt::Key_Up || event->key() == Qt::Key_Down)) {
+        addColumnCursor(event->key() == Qt::Key_Down ? 1 : -1);
+        event->accept();
+        return;
+    }
+    if (!m_extraCursors.isEmpty() && handleMultiCursorKey(event)) {
+        event->accept();
+        return;
+    }
+
+    // Ctrl+Espacio fuerza el autocompletado
+    const bool forceCompletion = (event->modifiers() & Qt::ControlModifier) && event->key() == Qt::Key_Space;
+    if (!forceCompletion) {
+        const QTextCursor c = textCursor();
+        prepareUndo(c.selectionStart(), c.selectionEnd());
+        QPlainTextEdit::keyPressEvent(event);
+    }
+    updateCompletion(forceCompletion, event->text());
+}
+
+// Aplica la tecla en todos los cursores; devuelve false si no es una tecla de edición
+// o movimiento y debe seguir el camino normal
+bool Editor::handleMultiCursorKey(QKeyEvent *event) {
+    const Qt::KeyboardModifiers mods = event->modifiers();
+    const QTextCursor::MoveMode mode = (mods & Qt::ShiftModifier) ? QTextCursor::KeepAnchor : QTextCursor::MoveAnchor;
+    const bool word = mods & Qt::ControlModifier;
+
+    switch (event->key()) {
+    case Qt::Key_Escape:
+        clearExtraCursors();
+        return true;
+    case Qt::Key_Backspace:
+        applyToAllCursors([](QTextCursor &c) {
+            if (c.hasSelection()) c.removeSelectedText();
+            else c.deletePreviousChar();
+        }, true);
+        return true;
+    case Qt::Key_Delete:
+        applyToAllCursors([](QTextCursor &c) {
+            if (c.hasSelection()) c.removeSelectedText();
+            else c.deleteChar();
+        }, true);
+        return true;
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        applyToAllCursors([](QTextCursor &c) { c.insertText(QStringLiteral("\n")); }, true);
+        return true;
+    case Qt::Key_Left:
+        applyToAllCursors([mode, word](QTextCursor &c) {
+            c.movePosition(word ? QTextCursor::PreviousWord : QTextCursor::Left, mode);
+        }, false);
+        return true;
+    case Qt::Key_Right:
+        applyToAllCursors([mode, word](QTextCursor &c) {
+            c.movePosition(word ? QTextCursor::NextWord : QTextCursor::Right, mode);
+        }, false);
+        return true;
+    case Qt::Key_Home:
+        applyToAllCursors([mode](QTextCursor &c) { c.movePosition(QTextCursor::StartOfBlock, mode); }, false);
+        return true;
+    case Qt::Key_End:
+        applyToAllCursors([mode](QTextCursor &c) { c.movePosition(QTextCursor::EndOfBlock, mode); }, false);
+        return true;
+    case Qt::Key_Up:
+    case Qt::Key_Down: {
+        // Movimiento por bloques lógicos: los bloques fuera de pantalla no tienen layout
+        const bool down = event->key() == Qt::Key_Down;
+        applyToAllCursors([mode, down](QTextCursor &c) {
+            const int column = c.positionInBlock();
+            const QTextBlock target = down ? c.block().next() : c.block().previous();
+            if (!target.isValid()) return;
+            c.setPosition(target.position() + qMin(column, target.length() - 1), mode);
+        }, false);
+        return true;
+    }
+    default:
+        break;
+    }
+
+    const QString text = event->text();
+    if (!text.isEmpty() && !(mods & (Qt::ControlModifier | Qt::AltModifier))
+        && (text.at(0).isPrint() || text.at(0) == QLatin1Char('\t'))) {
+        applyToAllCursors([text](QTextCursor &c) { c.insertText(text); }, true);
+        return true;
+    }
+    return false;
+}
+
+// Ejecuta 'op' en todos los cursores dentro de un único bloque de edición:
+// un paso de deshacer, un contentsChange y un rehighlight por bloque afectado.
+// Se recorre de atrás hacia delante para que cada edición solo desplace a los
+// cursores ya procesados, y ese desplazamiento se acumula en lugar de aplicarse
+// uno a uno (O(k) en vez de O(k²) con k cursores).
+void Editor::applyToAllCursors(const std::function<void(QTextCursor &)> &op, bool edits) {
+    struct Entry {
+        int anchor;
+        int position;
+        bool primary;
+        int cumulative;
+    };
+    QVector<Entry> all;
+    all.reserve(m_extraCursors.size() + 1);
+    for (const CursorRange &c : std::as_const(m_extraCursors))
+        all.push_back({c.anchor, c.position, false, 0});
+    const QTextCursor primary = textCursor();
+    all.push_back({primary.anchor(), primary.position(), true, 0});
+    std::sort(all.begin(), all.end(), [](const Entry &a, const Entry &b) {
+        return qMin(a.anchor, a.position) > qMin(b.anchor, b.position);
+    });
+
+    if (edits) {
+        int from = document()->characterCount();
+        int to = 0;
+        for (const Entry &e : std::as_const(all)) {
+            from = qMin(from, qMin(e.anchor, e.position));
+            to = qMax(to, qMax(e.anchor, e.position));
+        }
+        prepareUndo(from, to);
+    }
+
+    m_inMultiEdit = true;
+    QTextCursor batch(document());
+    if (edits) batch.beginEditBlock();
+    int total = 0;
+    for (Entry &e : all) {
+        QTextCursor c(document());
+        c.setPosition(e.anchor);
+        c.setPosition(e.position, QTextCursor::KeepAnchor);
+        const int before = document()->characterCount();
+        op(c);
+        total += document()->characterCount() - before;
+        e.anchor = c.anchor();
+        e.position = c.position();
+        e.cumulative = total;
+    }
+    if (edits) batch.endEditBlock();
+    m_inMultiEdit = false;
+
+    const int maxPos = document()->characterCount() - 1;
+    QTextCursor newPrimary(document());
+    m_extraCursors.clear();
+    for (const Entry &e : std::as_const(all)) {
+        const int shift = total - e.cumulative;
+        const CursorRange r{qBound(0, e.anchor + shift, maxPos), qBound(0, e.position + shift, maxPos)};
+        if (e.primary) {
+            newPrimary.setPosition(r.anchor);
+            newPrimary.setPosition(r.position, QTextCursor::KeepAnchor);
+        } else {
+            m_extraCursors.push_back(r);
+        }
+    }
+    setTextCursor(newPrimary);
+    normalizeCursors();
+    highlightCurrentLine();
+    viewport()->update();
+}
+
+// Ordena por posición y elimina duplicados (incluido el cursor principal)
+void Editor::normalizeCursors() {
+    const int primary = textCursor().position();
+    std::sort(m_extraCursors.begin(), m_extraCursors.end(), [](const CursorRange &a, const CursorRange &b) {
+        return a.position < b.position;
+    });
+    auto last = std::unique(m_extraCursors.begin(), m_extraCursors.end(), [](const CursorRange &a, const CursorRange &b) {
+        return a.position == b.position;
+    });
+    m_extraCursors.erase(last, m_extraCursors.end());
+    m_extraCursors.erase(std::remove_if(m_extraCursors.begin(), m_extraCursors.end(),
+                                        [primary](const CursorRange &c) { return c.position == primary; }),
+                         m_extraCursors.end());
+}
+
+void Editor::clearExtraCursors() {
+    if (m_extraCursors.isEmpty()) return;
+    m_extraCursors.clear();
+    highlightCurrentLine();
+    viewport()->update();
+}
 
-            m_zoomLevel = 0;
-            emit zoomLevelChanged(m_zoomLevel);
+// Ctrl+D: sin selección selecciona la palabra; con selección añade un cursor
+// en la siguiente aparición, que pasa a ser el principal
+void Editor::addNextOccurrence() {
+    QTextCursor primary = textCursor();
+    if (!primary.hasSelection()) {
+        primary.select(QTextCursor::WordUnderCursor);
+        setTextCursor(primary);
+        return;
+    }
+
+    const QString needle = primary.selectedText();
+    int from = primary.selectionEnd();
+    for (const CursorRange &c : std::as_const(m_extraCursors))
+        from = qMax(from, qMax(c.anchor, c.position));
+
+    QTextCursor found = document()->find(needle, from, QTextDocument::FindCaseSensitively);
+    if (found.isNull()) found = document()->find(needle, 0, QTextDocument::FindCaseSensitively);
+    if (found.isNull() || found.selectionStart() == primary.selectionStart()) return;
+    for (const CursorRange &c : std::as_const(m_extraCursors)) {
+        if (qMin(c.anchor, c.position) == found.selectionStart()) return;
+    }
+
+    m_extraCursors.append({primary.anchor(), primary.position()});
+    setTextCursor(found);
+    normalizeCursors();
+    highlightCurrentLine();
+    viewport()->update();
+}
+
+// Alt+Shift+Arriba/Abajo: cursor en la misma columna de la línea vecina
+void Editor::addColumnCursor(int direction) {
+    QTextCursor edge = textCursor();
+    for (const CursorRange &c : std::as_const(m_extraCursors)) {
+        if ((direction > 0 && c.position > edge.position()) || (direction < 0 && c.position < edge.position()))
+            edge.setPosition(c.position);
+    }
+    const QTextBlock target = direction > 0 ? edge.block().next() : edge.block().previous();
+    if (!target.isValid()) return;
+
+    const QTextCursor primary = textCursor();
+    m_extraCursors.append({primary.anchor(), primary.position()});
+    QTextCursor next(document());
+    next.setPosition(target.position() + qMin(edge.positionInBlock(), target.length() - 1));
+    setTextCursor(next);
+    normalizeCursors();
+    highlightCurrentLine();
+    viewport()->update();
+}
+
+// Selección rectangular desde el ancla (bloque, columna) hasta 'current'
+void Editor::updateColumnSelection(const QTextCursor &current) {
+    const int currentBlock = current.blockNumber();
+    const int column = current.positionInBlock();
+    const bool down = currentBlock >= m_columnAnchorBlock;
+
+    m_extraCursors.clear();
+    QTextCursor primary(document());
+    for (QTextBlock b = document()->findBlockByNumber(m_columnAnchorBlock); b.isValid();
+         b = down ? b.next() : b.previous()) {
+        const int length = b.length() - 1;
+        const CursorRange r{b.position() + qMin(m_columnAnchorColumn, length), b.position() + qMin(column, length)};
+        if (b.blockNumber() == currentBlock) {
+            primary.setPosition(r.anchor);
+            primary.setPosition(r.position, QTextCursor::KeepAnchor);
+            break;
+        }
+        m_extraCursors.append(r);
+    }
+    setTextCursor(primary);
+    normalizeCursors();
+    highlightCurrentLine();
+    viewport()->update();
+}
+
+void Editor::mousePressEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton) {
+        const Qt::KeyboardModifiers mods = event->modifiers();
+        const QTextCursor clicked = cursorForPosition(event->position().toPoint());
+        if (mods == (Qt::AltModifier | Qt::ShiftModifier)) {
+            m_columnSelecting = true;
+            m_columnAnchorBlock = clicked.blockNumber();
+            m_columnAnchorColumn = clicked.positionInBlock();
+            updateColumnSelection(clicked);
+            event->accept();
+            return;
+        }
+        if (mods == Qt::AltModifier) {
+            m_extraCursors.append({clicked.position(), clicked.position()});
+            normalizeCursors();
+            highlightCurrentLine();
+            viewport()->update();
+            event->accept();
+            return;
         }
+        clearExtraCursors();
+    }
+    QPlainTextEdit::mousePressEvent(event);
+}
+
+void Editor::mouseMoveEvent(QMouseEvent *event) {
+    if (m_columnSelecting && (event->buttons() & Qt::LeftButton)) {
+        updateColumnSelection(cursorForPosition(event->position().toPoint()));
+        event->accept();
+        return;
+    }
+    QPlainTextEdit::mouseMoveEvent(event);
+}
+
+void Editor::mouseReleaseEvent(QMouseEvent *event) {
+    if (m_columnSelecting) {
+        m_columnSelecting = false;
         event->accept();
         return;
     }
+    QPlainTextEdit::mouseReleaseEvent(event);
+}
+
+// Cortar, pegar y borrar del menú contextual editan alrededor de la selección
+void Editor::contextMenuEvent(QContextMenuEvent *event) {
+    const QTextCursor c = textCursor();
+    prepareUndo(c.selectionStart(), c.selectionEnd());
+    QPlainTextEdit::contextMenuEvent(event);
+}
+
+// Arrastrar mueve texto entre dos puntos cualesquiera: se prepara todo el documento
+void Editor::dropEvent(QDropEvent *event) {
+    prepareUndo(0, document()->characterCount());
+    QPlainTextEdit::dropEvent(event);
+}
+
+void Editor::insertFromMimeData(const QMimeData *source) {
+    const QTextCursor c = textCursor();
+    prepareUndo(c.selectionStart(), c.selectionEnd());
+    QPlainTextEdit::insertFromMimeData(source);
+}
+
+// Los métodos de entrada (acentos muertos, CJK) confirman texto sin pasar
+// por keyPressEvent: se prepara la selección, el rango que reemplazan y lo
+// que ocupa el preedit que se está confirmando
+void Editor::inputMethodEvent(QInputMethodEvent *event) {
+    const QTextCursor c = textCursor();
+    int from = c.selectionStart();
+    int to = c.selectionEnd();
+    if (event->replacementLength() > 0) {
+        from = qMin(from, c.position() + event->replacementStart());
+        to = qMax(to, c.position() + event->replacementStart() + event->replacementLength());
+    }
+    const QTextLayout *layout = c.block().layout();
+    const int preedit = layout ? int(layout->preeditAreaText().size()) : 0;
+    prepareUndo(qMax(0, from), to + qMax(preedit, int(event->commitString().size())));
+    QPlainTextEdit::inputMethodEvent(event);
+}
+
+// ---------- Deshacer / rehacer ----------
+
+// Prepara [from, to) más la línea anterior y la siguiente (borrar palabra o
+// un salto de línea sale del rango), acotado para no copiar líneas enormes
+void Editor::prepareUndo(int from, int to) {
+    const QTextBlock first = document()->findBlock(from);
+    const QTextBlock last = document()->findBlock(to);
+    const QTextBlock before = first.previous().isValid() ? first.previous() : first;
+    const QTextBlock after = last.next().isValid() ? last.next() : last;
+    m_document->history()->prepare(qMax(before.position(), from - UNDO_CONTEXT),
+                       qMin(after.position() + after.length(), to + UNDO_CONTEXT));
+}
+
+void Editor::undo() {
+    const int position = m_document->history()->undo();
+    if (position < 0) return;
+    QTextCursor c = textCursor();
+    c.setPosition(position);
+    setTextCursor(c);
+    ensureCursorVisible();
+}
+
+void Editor::redo() {
+    const int position = m_document->history()->redo();
+    if (position < 0) return;
+    QTextCursor c = textCursor();
+    c.setPosition(position);
+    setTextCursor(c);
+    ensureCursorVisible();
+}
+
+// Dibuja los cursores extra que caen en la zona visible
+void Editor::paintEvent(QPaintEvent *event) {
+    QPlainTextEdit::paintEvent(event);
+    if (m_extraCursors.isEmpty()) return;
+
+    const int first = firstVisibleBlock().position();
+    const QTextBlock lastBlock = cursorForPosition(QPoint(viewport()->width(), viewport()->height())).block();
+    const int last = lastBlock.position() + lastBlock.length();
+
+    QPainter painter(viewport());
+    auto it = std::lower_bound(m_extraCursors.cbegin(), m_extraCursors.cend(), first,
+                               [](const CursorRange &c, int pos) { return c.position < pos; });
+    for (; it != m_extraCursors.cend() && it->position <= last; ++it) {
+        QTextCursor c(document());
+        c.setPosition(it->position);
+        if (!c.block().isVisible()) continue;
+        const QRect r = cursorRect(c);
+        painter.fillRect(QRect(r.left(), r.top(), qMax(1, cursorWidth()), r.height()), QColor(220, 230, 245));
+    }
+}
+
+// El lado del documento (clangd, índice de palabras) lo lleva Document;
+// aquí solo se actualiza lo que depende de la vista
+void Editor::onContentsChange(int position, int charsRemoved, int charsAdded) {
+    if (LspClient *client = m_document->languageClient()) {
+        client->cancel(m_semanticRequest);
+        m_semanticRequest = 0;
+        m_semanticTimer->start();
+    }
+
+    // Los marcadores de plegado visibles pueden cambiar por una edición fuera de la vista
+    m_lineNumberArea->update();
+
+    // Cambios ajenos al multicursor (deshacer, recarga...) desplazan los cursores extra
+    if (!m_extraCursors.isEmpty() && !m_inMultiEdit) {
+        const int removedEnd = position + charsRemoved;
+        const auto adjust = [&](int p) {
+            if (p >= removedEnd) return p + charsAdded - charsRemoved;
+            return p > position ? position : p;
+        };
+        for (CursorRange &c : m_extraCursors) {
+            c.anchor = adjust(c.anchor);
+            c.position = adjust(c.position);
+        }
+    }
+}
+
+void Editor::requestSemanticTokens() {
+    LspClient *client = m_document->languageClient();
+    if (!client || m_document->filePath().isEmpty()) return;
+    client->cancel(m_semanticRequest);
+
+    const int firstLine = firstVisibleBlock().blockNumber();
+    const int lastVisible = cursorForPosition(QPoint(0, viewport()->height() - 1)).blockNumber();
+    const int lastLine = qMax(firstLine, lastVisible) + 1;
+    m_semanticRequest = client->requestSemanticTokens(m_document->filePath(), firstLine, lastLine, this,
+        [this, firstLine, lastLine](const QVector<SemanticToken> &tokens) {
+            m_semanticRequest = 0;
+            applySemanticTokens(firstLine, lastLine, tokens);
+        });
+}
+
+// Solo se rehighlightean los bloques cuyos tokens cambiaron
+void Editor::applySemanticTokens(int firstLine, int lastLine, const QVector<SemanticToken> &tokens) {
+    QHash<int, QVector<SemanticToken>> byLine;
+    for (const SemanticToken &t : tokens) byLine[t.line].append(t);
+
+    for (QTextBlock block = document()->findBlockByNumber(firstLine);
+         block.isValid() && block.blockNumber() < lastLine; block = block.next()) {
+        const QVector<SemanticToken> lineTokens = byLine.value(block.blockNumber());
+        if (!BlockData::of(block) && lineTokens.isEmpty()) continue;
+
+        BlockData *data = BlockData::ensure(block);
+        if (data->semanticTokens == lineTokens && data->semanticRevision == block.revision()) continue;
+        data->semanticTokens = lineTokens;
+        data->semanticRevision = block.revision();
+        m_document->highlighter()->rehighlightBlock(block);
+    }
+}
+
+QString Editor::wordUnderCursor() const {
+    const QTextCursor tc = textCursor();
+    const QString text = tc.block().text();
+    int start = tc.positionInBlock();
+    while (start > 0 && (text[start - 1].isLetterOrNumber() || text[start - 1] == QLatin1Char('_')))
+        --start;
+    return text.mid(start, tc.positionInBlock() - start);
+}
+
+void Editor::updateCompletion(bool force, const QString &typed) {
+    QAbstractItemView *popup = m_completer->popup();
+    if (!m_extraCursors.isEmpty()) return;
+    const bool wordChar = !typed.isEmpty() && (typed.back().isLetterOrNumber() || typed.back() == QLatin1Char('_'));
+    if (!force && !wordChar && !popup->isVisible())
+        return;
+
+    const QString prefix = wordUnderCursor();
+    if (prefix.size() < (force ? 1 : 2) || textCursor().hasSelection()) {
+        popup->hide();
+        return;
+    }
+
+    const QStringList candidates = CompletionIndex::instance().complete(prefix);
+    if (candidates.isEmpty()) {
+        popup->hide();
+        return;
+    }
+
+    m_completionModel->setStringList(candidates);
+    popup->setCurrentIndex(m_completer->completionModel()->index(0, 0));
+    QRect rect = cursorRect();
+    rect.setWidth(popup->sizeHintForColumn(0) + popup->verticalScrollBar()->sizeHint().width());
+    m_completer->complete(rect);
+}
 
-    QPlainTextEdit::keyPressEvent(event);
+void Editor::insertCompletion(const QString &completion) {
+    if (m_completer->widget() != this) return;
+    QTextCursor tc = textCursor();
+    tc.movePosition(QTextCursor::Left, QTextCursor::KeepAnchor, wordUnderCursor().size());
+    prepareUndo(tc.selectionStart(), tc.selectionEnd());
+    tc.insertText(completion);
+    setTextCursor(tc);
 }
@@ -1,43 +1,163 @@
 #pragma once
 
 #include <QPlainTextEdit>
+#include <QHash>
+#include <functional>
 
+#include "BlockData.h"
+#include "Diagnostic.h"
+
+class Document;
 class LineNumberArea;
-class CppHighlighter;
+class Minimap;
+class QCompleter;
+class QStringListModel;
+class QTimer;
 
 class Editor : public QPlainTextEdit {
     Q_OBJECT
 
 public:
-    explicit Editor(QWidget *parent = nullptr);
-    void newDocument();
-    void openFile(const QString &filePath);
-    void save();
+    // Posición de la vista que se guarda al cambiar de pestaña
+    struct ViewState {
+        bool valid = false;
+        int anchor = 0;
+        int position = 0;
+        int verticalScroll = 0;
+        int horizontalScroll = 0;
+        QList<int> folded;
+    };
+
+    explicit Editor(Document *document, QWidget *parent = nullptr);
+    ~Editor() override;
+    // Muestra otro documento; sin estado previo se recuperan los pliegues guardados
+    void showDocument(Document *document, const ViewState &state = ViewState());
+    Document *currentDocument() const { return m_document; }
+    ViewState viewState() const;
+    bool save();
+    QString currentFile() const;
+
+    // Reemplaza los diagnósticos de una fuente (clangd, compilador...)
+    void setDiagnostics(const QString &source, const QVector<Diagnostic> &diagnostics);
+
+    // Lleva el cursor a (línea, columna), ambas desde 0, y lo centra
+    void goToLine(int line, int column = 0);
+
+    // ---------- Minimapa ----------
+    int firstVisibleLine() const;
+    int visibleLineCount() const;
+    void scrollToLine(int blockNumber);
 
     int lineNumberAreaWidth() const;
     void lineNumberAreaPaintEvent(QPaintEvent *event);
+    void lineNumberAreaMousePressEvent(QMouseEvent *event);
+
+    // ---------- Multicursor ----------
+    void addNextOccurrence();
+    void clearExtraCursors();
+
+    void toggleFold(int blockNumber);
+    // Pliega o despliega varios bloques con un único relayout
+    void setFolded(const QList<int> &startBlocks, bool fold);
+
+    int zoomLevel() const { return m_zoomLevel; }
+    void setZoomLevel(int level);
+    // Otra vista del mismo documento cambió el zoom: la fuente del documento
+    // ya es la nueva y aquí solo se ajustan el nivel y la fuente de la vista
+    void followZoomLevel(int level);
+
+public slots:
+    // Ocultan los de QPlainTextEdit: el historial lo lleva UndoHistory
+    void undo();
+    void redo();
 
 signals:
     void zoomLevelChanged(int newZoomLevel);
 
 protected:
+    bool event(QEvent *event) override;
+    void changeEvent(QEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+    void dropEvent(QDropEvent *event) override;
+    void insertFromMimeData(const QMimeData *source) override;
+    void inputMethodEvent(QInputMethodEvent *event) override;
 
 private slots:
     void updateLineNumberAreaWidth(int newBlockCount);
     void highlightCurrentLine();
     void updateLineNumberArea(const QRect &rect, int dy);
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+    void insertCompletion(const QString &completion);
+    void requestSemanticTokens();
+    void revealCursorBlock();
 
 private:
+    // Cursores adicionales como posiciones planas: mantener miles de
+    // QTextCursor vivos haría que cada inserción los ajustara uno a uno
+    struct CursorRange {
+        int anchor;
+        int position;
+    };
+
+    bool handleMultiCursorKey(QKeyEvent *event);
+    void applyToAllCursors(const std::function<void(QTextCursor &)> &op, bool edits);
+    void normalizeCursors();
+    void addColumnCursor(int direction);
+    void updateColumnSelection(const QTextCursor &current);
+
+    void prepareUndo(int from, int to);
+    void updateWrapMode();
+    void updateSideAreas();
+    // Fuente con zoom y tabulador de 4 espacios en el QTextDocument mostrado
+    void applyDocumentFont();
+    void applyTabStop(const QFont &font);
+    void applyZoom();
+    void followLongLine(int column);
+
+    int foldMarkerWidth() const;
+    QString wordUnderCursor() const;
+    void updateCompletion(bool force, const QString &typed);
+    void applySemanticTokens(int firstLine, int lastLine, const QVector<SemanticToken> &tokens);
+    void rebuildDiagnosticSelections();
+    QPair<int, int> foldRange(const QTextBlock &block) const;
+    QList<int> foldedBlocks() const;
+    void saveFoldState() const;
+    void restoreFoldState();
+
     QWidget *m_lineNumberArea;
-    QString m_currentFile;
-    CppHighlighter *m_highlighter;
+    Minimap *m_minimap;
+    Document *m_document = nullptr;
+    QList<QMetaObject::Connection> m_documentConnections;
+    QCompleter *m_completer;
+    QStringListModel *m_completionModel;
+
+    QTimer *m_semanticTimer;
+    int m_semanticRequest = 0;
+
+    QList<QTextEdit::ExtraSelection> m_diagnosticSelections;
+    QStringList m_diagnosticMessages;
+    QHash<int, Diagnostic::Severity> m_diagnosticLines;   // la más grave por bloque, para el gutter
+
+    QTextCursor m_scrollAnchor;            // primera línea visible durante una recarga
+    bool m_pinnedToEnd = false;            // la vista estaba al final antes de añadir
+    QVector<CursorRange> m_extraCursors;   // ordenados por posición
+    bool m_inMultiEdit = false;
+    bool m_columnSelecting = false;
+    int m_columnAnchorBlock = 0;
+    int m_columnAnchorColumn = 0;
 
     int m_zoomLevel = 0;
+    qreal m_basePointSize = 0;        // tamaño de fuente con zoom 0
     static constexpr int MAX_ZOOM = 10;
     static constexpr int MIN_ZOOM = -10;
+    static constexpr int UNDO_CONTEXT = 4096;   // caracteres preparados a cada lado
 };
 
 class LineNumberArea : public QWidget {
@@ -47,6 +167,7 @@ public:
 
 protected:
     void paintEvent(QPaintEvent *event) override { m_editor->lineNumberAreaPaintEvent(event); }
+    void mousePressEvent(QMouseEvent *event) override { m_editor->lineNumberAreaMousePressEvent(event); }
 
 private:
     Editor *m_editor;
@@ -0,0 +1,293 @@
+#include "HexView.h"
+
+#include <QCoreApplication>
+#include <QFontDatabase>
+#include <QInputDialog>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QScrollBar>
+#include <QStringDecoder>
+#include <QThreadPool>
+
+#include <climits>
+#include <cstring>
+
+namespace {
+
+// memchr localiza candidatos para el primer byte; la libc lo implementa con
+// instrucciones vectoriales (SSE2/AVX2/NEON) y recorre varios GB por segundo
+qint64 findIn(const uchar *data, qint64 length, const QByteArray &pattern) {
+    const qint64 m = pattern.size();
+    if (length < m) return -1;
+    const uchar first = uchar(pattern.front());
+    const uchar *p = data;
+    const uchar *end = data + length - m + 1;
+    while (p < end) {
+        p = static_cast<const uchar *>(std::memchr(p, first, size_t(end - p)));
+        if (!p) return -1;
+        if (std::memcmp(p, pattern.constData(), size_t(m)) == 0) return p - data;
+        ++p;
+    }
+    return -1;
+}
+
+// Recorre el fichero por ventanas proyectadas que se solapan en
+// pattern.size() - 1 bytes para no perder coincidencias en los bordes
+qint64 scanFile(const QString &filePath, const QByteArray &pattern, qint64 from) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return -1;
+    const qint64 size = file.size();
+    qint64 position = qMax<qint64>(0, from);
+    while (position + pattern.size() <= size) {
+        const qint64 length = qMin(HexView::MAP_WINDOW, size - position);
+        uchar *data = file.map(position, length);
+        if (!data) return -1;
+        const qint64 index = findIn(data, length, pattern);
+        file.unmap(data);
+        if (index >= 0) return position + index;
+        if (position + length >= size) break;
+        position += length - (pattern.size() - 1);
+    }
+    return -1;
+}
+
+} // namespace
+
+HexView::HexView(QWidget *parent)
+    : QAbstractScrollArea(parent) {
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setFocusPolicy(Qt::StrongFocus);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, viewport(), QOverload<>::of(&QWidget::update));
+}
+
+HexView::~HexView() {
+    if (m_map) m_file.unmap(m_map);
+}
+
+bool HexView::open(const QString &filePath) {
+    if (m_map) m_file.unmap(m_map);
+    m_map = nullptr;
+    m_mapLength = 0;
+    m_file.close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+    m_filePath = filePath;
+    m_size = m_file.size();
+    m_selectionStart = -1;
+    updateScrollBar();
+    viewport()->update();
+    return true;
+}
+
+bool HexView::isBinary(const QString &filePath) {
+    QFile f(filePath);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    const QByteArray head = f.read(SNIFF_BYTES);
+    if (head.contains('\0')) return true;
+    // Una secuencia cortada al final de la muestra queda pendiente, no es error
+    QStringDecoder decoder(QStringDecoder::Utf8);
+    const QString text = decoder.decode(head);
+    Q_UNUSED(text);
+    return decoder.hasError();
+}
+
+QByteArray HexView::parsePattern(const QString &text) {
+    static const QRegularExpression hexBytes(QStringLiteral("^\\s*(?:[0-9a-fA-F]{2}\\s*)+$"));
+    if (hexBytes.match(text).hasMatch())
+        return QByteArray::fromHex(text.simplified().remove(QLatin1Char(' ')).toLatin1());
+    QString plain = text;
+    if (plain.size() >= 2 && plain.startsWith(QLatin1Char('"')) && plain.endsWith(QLatin1Char('"')))
+        plain = plain.mid(1, plain.size() - 2);
+    return plain.toUtf8();
+}
+
+// ---------- Proyección ----------
+
+// Devuelve los bytes [offset, offset + length) reproyectando la ventana si
+// hace falta; la nueva empieza un poco antes para que subir no reproyecte
+const uchar *HexView::bytesAt(qint64 offset, qint64 length) {
+    if (m_map && offset >= m_mapOffset && offset + length <= m_mapOffset + m_mapLength)
+        return m_map + (offset - m_mapOffset);
+
+    if (m_map) m_file.unmap(m_map);
+    m_map = nullptr;
+    m_mapOffset = qMax<qint64>(0, offset - MAP_WINDOW / 4) & ~qint64(4095);
+    m_mapLength = qMin(MAP_WINDOW, m_size - m_mapOffset);
+    if (m_mapLength <= 0 || offset + length > m_mapOffset + m_mapLength) return nullptr;
+    m_map = m_file.map(m_mapOffset, m_mapLength);
+    return m_map ? m_map + (offset - m_mapOffset) : nullptr;
+}
+
+// ---------- Geometría ----------
+
+qint64 HexView::rowCount() const {
+    return (m_size + BYTES_PER_ROW - 1) / BYTES_PER_ROW;
+}
+
+int HexView::visibleRows() const {
+    return qMax(1, viewport()->height() / fontMetrics().height());
+}
+
+qint64 HexView::firstRow() const {
+    return qMin(qint64(verticalScrollBar()->value()) * m_rowsPerStep, qMax<qint64>(0, rowCount() - 1));
+}
+
+void HexView::updateScrollBar() {
+    const qint64 scrollable = qMax<qint64>(0, rowCount() - visibleRows());
+    m_rowsPerStep = scrollable / (INT_MAX / 2) + 1;
+    verticalScrollBar()->setRange(0, int(scrollable / m_rowsPerStep));
+    verticalScrollBar()->setPageStep(int(qMax<qint64>(1, visibleRows() / m_rowsPerStep)));
+}
+
+void HexView::scrollToRow(qint64 row) {
+    verticalScrollBar()->setValue(int(qMax<qint64>(0, row) / m_rowsPerStep));
+}
+
+void HexView::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBar();
+}
+
+// ---------- Pintado ----------
+// Columnas: desplazamiento, 16 bytes en hexadecimal (con un hueco a la
+// mitad) y su representación ASCII
+
+void HexView::paintEvent(QPaintEvent *) {
+    QPainter painter(viewport());
+    painter.fillRect(viewport()->rect(), QColor(18, 28, 48));
+    if (!m_file.isOpen()) return;
+
+    const QFontMetrics fm = fontMetrics();
+    const int charWidth = fm.horizontalAdvance(QLatin1Char('0'));
+    const int lineHeight = fm.height();
+    const int hexColumn = 12 * charWidth;
+    const int asciiColumn = hexColumn + (BYTES_PER_ROW * 3 + 2) * charWidth;
+
+    const qint64 first = firstRow();
+    const int rows = visibleRows() + 1;
+    const qint64 start = first * BYTES_PER_ROW;
+    const qint64 length = qMin<qint64>(qint64(rows) * BYTES_PER_ROW, m_size - start);
+    const uchar *data = length > 0 ? bytesAt(start, length) : nullptr;
+    if (!data) return;
+
+    const QColor offsetColor(120, 140, 170);
+    const QColor textColor(220, 230, 245);
+    const QColor selectionColor(30, 90, 170);
+    for (int row = 0; row < rows; ++row) {
+        const qint64 rowOffset = start + qint64(row) * BYTES_PER_ROW;
+        if (rowOffset >= m_size) break;
+        const int y = row * lineHeight;
+        painter.setPen(offsetColor);
+        painter.drawText(0, y + fm.ascent(), QStringLiteral("%1").arg(rowOffset, 10, 16, QLatin1Char('0')));
+
+        const int count = int(qMin<qint64>(BYTES_PER_ROW, m_size - rowOffset));
+        for (int i = 0; i < count; ++i) {
+            const qint64 offset = rowOffset + i;
+            const uchar byte = data[offset - start];
+            const int x = hexColumn + (i * 3 + (i >= BYTES_PER_ROW / 2 ? 1 : 0)) * charWidth;
+            const int ax = asciiColumn + i * charWidth;
+            if (offset >= m_selectionStart && offset < m_selectionStart + m_selectionLength) {
+                painter.fillRect(QRect(x, y, 2 * charWidth, lineHeight), selectionColor);
+                painter.fillRect(QRect(ax, y, charWidth, lineHeight), selectionColor);
+            }
+            painter.setPen(textColor);
+            painter.drawText(x, y + fm.ascent(), QStringLiteral("%1").arg(byte, 2, 16, QLatin1Char('0')));
+            painter.drawText(ax, y + fm.ascent(), QString(byte >= 0x20 && byte < 0x7f ? QChar(byte) : QChar('.')));
+        }
+    }
+}
+
+// ---------- Navegación ----------
+
+void HexView::goToOffset(qint64 offset) {
+    if (m_size == 0) return;
+    offset = qBound<qint64>(0, offset, m_size - 1);
+    m_selectionStart = offset;
+    m_selectionLength = 1;
+    const qint64 row = offset / BYTES_PER_ROW;
+    if (row < firstRow() || row >= firstRow() + visibleRows()) scrollToRow(row - visibleRows() / 2);
+    viewport()->update();
+}
+
+void HexView::find(const QByteArray &pattern, qint64 from) {
+    if (pattern.isEmpty() || m_searching) return;
+    m_searching = true;
+    m_lastPattern = pattern;
+
+    const QString filePath = m_filePath;
+    QPointer<HexView> guard(this);
+    QThreadPool::globalInstance()->start([filePath, pattern, from, guard]() {
+        const qint64 found = scanFile(filePath, pattern, from);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, found, pattern]() {
+            if (!guard) return;
+            guard->m_searching = false;
+            if (found >= 0) {
+                guard->goToOffset(found);
+                guard->m_selectionLength = pattern.size();
+            }
+            emit guard->searchFinished(found >= 0);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void HexView::keyPressEvent(QKeyEvent *event) {
+    const bool ctrl = event->modifiers() & Qt::ControlModifier;
+    QScrollBar *bar = verticalScrollBar();
+    if (ctrl && event->key() == Qt::Key_G) {
+        bool ok = false;
+        const QString text = QInputDialog::getText(this, tr("Ir a"), tr("Desplazamiento (decimal o 0x...):"),
+                                                   QLineEdit::Normal, QString(), &ok).trimmed();
+        const qint64 offset = text.startsWith(QLatin1String("0x"), Qt::CaseInsensitive)
+            ? text.mid(2).toLongLong(&ok, 16) : text.toLongLong(&ok, 10);
+        if (ok) goToOffset(offset);
+    } else if (ctrl && event->key() == Qt::Key_F) {
+        bool ok = false;
+        const QString text = QInputDialog::getText(this, tr("Buscar"), tr("Bytes (7f 45 4c 46) o texto:"),
+                                                   QLineEdit::Normal, QString(), &ok);
+        if (ok) find(parsePattern(text), qMax<qint64>(0, m_selectionStart));
+    } else if (event->key() == Qt::Key_F3) {
+        find(m_lastPattern, m_selectionStart + 1);
+    } else if (event->key() == Qt::Key_Up) {
+        bar->triggerAction(QAbstractSlider::SliderSingleStepSub);
+    } else if (event->key() == Qt::Key_Down) {
+        bar->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+    } else if (event->key() == Qt::Key_PageUp) {
+        bar->triggerAction(QAbstractSlider::SliderPageStepSub);
+    } else if (event->key() == Qt::Key_PageDown) {
+        bar->triggerAction(QAbstractSlider::SliderPageStepAdd);
+    } else if (ctrl && event->key() == Qt::Key_Home) {
+        bar->setValue(bar->minimum());
+    } else if (ctrl && event->key() == Qt::Key_End) {
+        bar->setValue(bar->maximum());
+    } else {
+        QAbstractScrollArea::keyPressEvent(event);
+        return;
+    }
+    event->accept();
+}
+
+void HexView::mousePressEvent(QMouseEvent *event) {
+    const int charWidth = fontMetrics().horizontalAdvance(QLatin1Char('0'));
+    const int hexColumn = 12 * charWidth;
+    const int asciiColumn = hexColumn + (BYTES_PER_ROW * 3 + 2) * charWidth;
+    const int x = int(event->position().x());
+    int column = -1;
+    if (x >= asciiColumn) {
+        column = (x - asciiColumn) / charWidth;
+    } else if (x >= hexColumn) {
+        int cell = (x - hexColumn) / charWidth;
+        if (cell >= BYTES_PER_ROW / 2 * 3) --cell;
+        column = cell / 3;
+    }
+    if (column < 0 || column >= BYTES_PER_ROW) return;
+    const qint64 row = firstRow() + int(event->position().y()) / fontMetrics().height();
+    const qint64 offset = row * BYTES_PER_ROW + column;
+    if (offset >= m_size) return;
+    m_selectionStart = offset;
+    m_selectionLength = 1;
+    viewport()->update();
+}
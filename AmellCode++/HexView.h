@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QByteArray>
+#include <QFile>
+
+// Vista hexadecimal de solo lectura para binarios (objetos, core dumps...).
+// El fichero no se carga: se proyecta en memoria por ventanas de
+// MAP_WINDOW bytes alrededor de lo visible, así que abrir un fichero de
+// varios GB ocupa lo mismo que uno pequeño. Solo se pintan las filas que
+// caben en el viewport.
+//
+// Ctrl+G salta a un desplazamiento (decimal o 0x...), Ctrl+F busca una
+// secuencia de bytes ("7f 45 4c 46") o un texto y F3 busca la siguiente.
+class HexView : public QAbstractScrollArea {
+    Q_OBJECT
+public:
+    explicit HexView(QWidget *parent = nullptr);
+    ~HexView() override;
+
+    bool open(const QString &filePath);
+    const QString &filePath() const { return m_filePath; }
+
+    void goToOffset(qint64 offset);
+    // Busca en un hilo del pool a partir de 'from'; el resultado se selecciona
+    void find(const QByteArray &pattern, qint64 from);
+
+    // Heurística de apertura: un NUL o UTF-8 inválido al principio del fichero
+    static bool isBinary(const QString &filePath);
+    // "7f 45 4c 46" como bytes; cualquier otra cosa (o entre comillas) como texto UTF-8
+    static QByteArray parsePattern(const QString &text);
+
+    static constexpr int BYTES_PER_ROW = 16;
+    static constexpr qint64 MAP_WINDOW = 64 * 1024 * 1024;
+    static constexpr int SNIFF_BYTES = 8192;
+
+signals:
+    void searchFinished(bool found);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    const uchar *bytesAt(qint64 offset, qint64 length);
+    qint64 rowCount() const;
+    qint64 firstRow() const;
+    int visibleRows() const;
+    void updateScrollBar();
+    void scrollToRow(qint64 row);
+
+    QFile m_file;
+    QString m_filePath;
+    qint64 m_size = 0;
+    uchar *m_map = nullptr;           // ventana proyectada actual
+    qint64 m_mapOffset = 0;
+    qint64 m_mapLength = 0;
+
+    // Con más filas de las que admite un QScrollBar cada paso cubre varias
+    qint64 m_rowsPerStep = 1;
+
+    qint64 m_selectionStart = -1;
+    qint64 m_selectionLength = 0;
+    QByteArray m_lastPattern;
+    bool m_searching = false;
+};
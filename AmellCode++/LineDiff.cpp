@@ -0,0 +1,84 @@
+#include "LineDiff.h"
+
+#include <utility>
+#include <vector>
+
+QVector<DiffHunk> diffLines(const QStringList &before, const QStringList &after) {
+    const int common = qMin(before.size(), after.size());
+    int prefix = 0;
+    while (prefix < common && before[prefix] == after[prefix]) ++prefix;
+    int suffix = 0;
+    while (suffix < common - prefix && before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix])
+        ++suffix;
+
+    const int n = before.size() - prefix - suffix;
+    const int m = after.size() - prefix - suffix;
+    QVector<DiffHunk> hunks;
+    if (n == 0 && m == 0) return hunks;
+
+    const auto same = [&](int x, int y) { return before[prefix + x] == after[prefix + y]; };
+
+    // ---------- Avance ----------
+    // trace[d][k + d] es la x más lejana alcanzada en la diagonal k con d ediciones
+    std::vector<std::vector<int>> trace;
+    int endD = -1;
+    const int maxD = qMin(n + m, MAX_EDIT_DISTANCE);
+    for (int d = 0; d <= maxD && endD < 0; ++d) {
+        std::vector<int> v(2 * d + 1);
+        for (int k = -d; k <= d; k += 2) {
+            int x = 0;
+            if (d > 0) {
+                const std::vector<int> &prev = trace.back();
+                const bool down = k == -d || (k != d && prev[k - 1 + d - 1] < prev[k + 1 + d - 1]);
+                x = down ? prev[k + 1 + d - 1] : prev[k - 1 + d - 1] + 1;
+            }
+            int y = x - k;
+            while (x < n && y < m && same(x, y)) {
+                ++x;
+                ++y;
+            }
+            v[k + d] = x;
+            if (x >= n && y >= m) {
+                endD = d;
+                break;
+            }
+        }
+        trace.push_back(std::move(v));
+    }
+
+    if (endD < 0) {
+        hunks.append({prefix, n, after.mid(prefix, m)});
+        return hunks;
+    }
+
+    // ---------- Retroceso: pares de líneas iguales ----------
+    std::vector<std::pair<int, int>> matches;
+    int x = n, y = m;
+    for (int d = endD; d > 0; --d) {
+        const std::vector<int> &prev = trace[d - 1];
+        const int k = x - y;
+        const bool down = k == -d || (k != d && prev[k - 1 + d - 1] < prev[k + 1 + d - 1]);
+        const int prevK = down ? k + 1 : k - 1;
+        const int prevX = prev[prevK + d - 1];
+        const int prevY = prevX - prevK;
+        const int startX = down ? prevX : prevX + 1;
+        while (x > startX) matches.emplace_back(--x, --y);
+        x = prevX;
+        y = prevY;
+    }
+    while (x > 0) matches.emplace_back(--x, --y);
+
+    // ---------- Trozos entre coincidencias ----------
+    int oldPos = 0, newPos = 0;
+    const auto flush = [&](int oldEnd, int newEnd) {
+        if (oldEnd > oldPos || newEnd > newPos)
+            hunks.append({prefix + oldPos, oldEnd - oldPos, after.mid(prefix + newPos, newEnd - newPos)});
+    };
+    for (auto it = matches.crbegin(); it != matches.crend(); ++it) {
+        flush(it->first, it->second);
+        oldPos = it->first + 1;
+        newPos = it->second + 1;
+    }
+    flush(n, m);
+    return hunks;
+}
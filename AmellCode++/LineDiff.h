@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QStringList>
+#include <QVector>
+
+// Sustituir las líneas [oldStart, oldStart + oldCount) del texto viejo por
+// 'newLines'. Los números de línea se refieren siempre al texto viejo, así
+// que los trozos se aplican de abajo arriba.
+struct DiffHunk {
+    int oldStart = 0;
+    int oldCount = 0;
+    QStringList newLines;
+};
+
+// Diferencia mínima por líneas (Myers) entre dos textos partidos por '\n'.
+// El prefijo y el sufijo comunes se descartan antes, así que regenerar un
+// fichero grande con pocos cambios cuesta lo que mide el cambio. Si hacen
+// falta más de MAX_EDIT_DISTANCE ediciones se devuelve un único trozo con
+// toda la zona intermedia.
+QVector<DiffHunk> diffLines(const QStringList &before, const QStringList &after);
+
+constexpr int MAX_EDIT_DISTANCE = 2000;
@@ -0,0 +1,278 @@
+#include "LspClient.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPointer>
+#include <QStandardPaths>
+#include <QUrl>
+
+static QString uriFor(const QString &filePath) {
+    return QUrl::fromLocalFile(QFileInfo(filePath).absoluteFilePath()).toString();
+}
+
+static QJsonObject position(int line, int character) {
+    return QJsonObject{{"line", line}, {"character", character}};
+}
+
+LspClient::LspClient(QObject *parent)
+    : QObject(parent),
+      m_process(new QProcess(this)) {
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &LspClient::onReadyRead);
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &LspClient::onFinished);
+}
+
+LspClient::~LspClient() {
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->disconnect(this);
+        m_process->kill();
+        m_process->waitForFinished(500);
+    }
+}
+
+bool LspClient::start(const QString &rootPath) {
+    const QString clangd = QStandardPaths::findExecutable("clangd");
+    if (clangd.isEmpty()) return false;
+
+    m_process->setProgram(clangd);
+    m_process->setArguments(QStringList() << "--background-index" << "--log=error"
+                                          << "--compile-commands-dir=" + rootPath + "/build");
+    m_process->setWorkingDirectory(rootPath);
+    m_process->start();
+    if (!m_process->waitForStarted(2000)) return false;
+
+    QJsonObject semanticTokens{
+        {"requests", QJsonObject{{"range", true}, {"full", false}}},
+        {"tokenTypes", QJsonArray{"namespace", "type", "class", "enum", "interface", "struct",
+                                  "typeParameter", "parameter", "variable", "property", "enumMember",
+                                  "function", "method", "macro", "concept"}},
+        {"tokenModifiers", QJsonArray{}},
+        {"formats", QJsonArray{"relative"}}
+    };
+    QJsonObject capabilities{
+        {"textDocument", QJsonObject{
+            {"synchronization", QJsonObject{{"didSave", true}}},
+            {"publishDiagnostics", QJsonObject{}},
+            {"semanticTokens", semanticTokens}
+        }}
+    };
+    QJsonObject params{
+        {"processId", static_cast<qint64>(QCoreApplication::applicationPid())},
+        {"rootUri", QUrl::fromLocalFile(rootPath).toString()},
+        {"capabilities", capabilities}
+    };
+
+    // initialize se envía directamente; el resto espera en m_queued
+    const int id = m_nextId++;
+    m_pending.insert(id, [this](const QJsonObject &result) { handleInitialized(result); });
+    QJsonObject message{{"jsonrpc", "2.0"}, {"id", id}, {"method", "initialize"}, {"params", params}};
+    const QByteArray body = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    m_process->write("Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body);
+    return true;
+}
+
+bool LspClient::isRunning() const {
+    return m_process->state() == QProcess::Running;
+}
+
+void LspClient::handleInitialized(const QJsonObject &result) {
+    const QJsonArray types = result.value("capabilities").toObject()
+                                   .value("semanticTokensProvider").toObject()
+                                   .value("legend").toObject()
+                                   .value("tokenTypes").toArray();
+    m_tokenTypes.clear();
+    for (const QJsonValue &t : types) m_tokenTypes.append(t.toString());
+
+    m_initialized = true;
+    sendNotification("initialized", QJsonObject{});
+    for (const QJsonObject &msg : std::as_const(m_queued)) write(msg);
+    m_queued.clear();
+}
+
+void LspClient::didOpen(const QString &filePath, const QString &text) {
+    if (!isRunning()) return;
+    m_versions.insert(filePath, 1);
+    const bool isC = filePath.endsWith(".c");
+    sendNotification("textDocument/didOpen", QJsonObject{
+        {"textDocument", QJsonObject{
+            {"uri", uriFor(filePath)},
+            {"languageId", isC ? "c" : "cpp"},
+            {"version", 1},
+            {"text", text}
+        }}
+    });
+}
+
+void LspClient::didClose(const QString &filePath) {
+    if (!isRunning() || !m_versions.remove(filePath)) return;
+    sendNotification("textDocument/didClose", QJsonObject{
+        {"textDocument", QJsonObject{{"uri", uriFor(filePath)}}}
+    });
+}
+
+void LspClient::didSave(const QString &filePath) {
+    if (!isRunning() || !m_versions.contains(filePath)) return;
+    sendNotification("textDocument/didSave", QJsonObject{
+        {"textDocument", QJsonObject{{"uri", uriFor(filePath)}}}
+    });
+}
+
+void LspClient::didChange(const QString &filePath, int startLine, int startCharacter,
+                          int endLine, int endCharacter, const QString &text) {
+    if (!isRunning() || !m_versions.contains(filePath)) return;
+    const int version = ++m_versions[filePath];
+    QJsonObject change{
+        {"range", QJsonObject{{"start", position(startLine, startCharacter)}, {"end", position(endLine, endCharacter)}}},
+        {"text", text}
+    };
+    sendNotification("textDocument/didChange", QJsonObject{
+        {"textDocument", QJsonObject{{"uri", uriFor(filePath)}, {"version", version}}},
+        {"contentChanges", QJsonArray{change}}
+    });
+}
+
+int LspClient::requestSemanticTokens(const QString &filePath, int startLine, int endLine,
+                                     QObject *context, TokensHandler handler) {
+    if (!isRunning() || !m_versions.contains(filePath)) return 0;
+    QJsonObject params{
+        {"textDocument", QJsonObject{{"uri", uriFor(filePath)}}},
+        {"range", QJsonObject{{"start", position(startLine, 0)}, {"end", position(endLine, 0)}}}
+    };
+    QPointer<QObject> guard(context);
+    return sendRequest("textDocument/semanticTokens/range", params,
+                       [this, guard, handler](const QJsonObject &result) {
+        if (!guard) return;
+        // Formato relativo: (deltaLine, deltaStart, length, type, modifiers)
+        const QJsonArray data = result.value("data").toArray();
+        QVector<SemanticToken> tokens;
+        tokens.reserve(data.size() / 5);
+        int line = 0, start = 0;
+        for (int i = 0; i + 4 < data.size(); i += 5) {
+            const int deltaLine = data[i].toInt();
+            const int deltaStart = data[i + 1].toInt();
+            line += deltaLine;
+            start = deltaLine ? deltaStart : start + deltaStart;
+            const SemanticToken::Kind kind = kindForType(data[i + 3].toInt());
+            if (kind == SemanticToken::KindCount) continue;
+            SemanticToken t;
+            t.line = line;
+            t.start = start;
+            t.length = data[i + 2].toInt();
+            t.kind = kind;
+            tokens.append(t);
+        }
+        handler(tokens);
+    });
+}
+
+void LspClient::cancel(int requestId) {
+    if (requestId <= 0 || !m_pending.remove(requestId)) return;
+    sendNotification("$/cancelRequest", QJsonObject{{"id", requestId}});
+}
+
+SemanticToken::Kind LspClient::kindForType(int typeIndex) const {
+    const QString type = m_tokenTypes.value(typeIndex);
+    if (type == "class" || type == "struct" || type == "enum" || type == "interface"
+        || type == "type" || type == "typeParameter" || type == "concept")
+        return SemanticToken::Type;
+    if (type == "namespace") return SemanticToken::Namespace;
+    if (type == "function" || type == "method") return SemanticToken::Function;
+    if (type == "macro") return SemanticToken::Macro;
+    if (type == "variable" || type == "parameter" || type == "property" || type == "enumMember")
+        return SemanticToken::Variable;
+    return SemanticToken::KindCount;
+}
+
+int LspClient::sendRequest(const QString &method, const QJsonObject &params, ResponseHandler handler) {
+    const int id = m_nextId++;
+    m_pending.insert(id, std::move(handler));
+    QJsonObject message{{"jsonrpc", "2.0"}, {"id", id}, {"method", method}, {"params", params}};
+    if (m_initialized) write(message);
+    else m_queued.append(message);
+    return id;
+}
+
+void LspClient::sendNotification(const QString &method, const QJsonObject &params) {
+    QJsonObject message{{"jsonrpc", "2.0"}, {"method", method}, {"params", params}};
+    if (m_initialized || method == "initialized") write(message);
+    else m_queued.append(message);
+}
+
+void LspClient::write(const QJsonObject &message) {
+    const QByteArray body = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    m_process->write("Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body);
+}
+
+void LspClient::onReadyRead() {
+    m_buffer += m_process->readAllStandardOutput();
+    for (;;) {
+        const int headerEnd = m_buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) return;
+
+        int length = -1;
+        const QList<QByteArray> headers = m_buffer.left(headerEnd).split('\n');
+        for (const QByteArray &h : headers) {
+            if (h.toLower().startsWith("content-length:"))
+                length = h.mid(15).trimmed().toInt();
+        }
+        if (length < 0) {
+            m_buffer.remove(0, headerEnd + 4);
+            continue;
+        }
+        if (m_buffer.size() < headerEnd + 4 + length) return;
+
+        const QByteArray body = m_buffer.mid(headerEnd + 4, length);
+        m_buffer.remove(0, headerEnd + 4 + length);
+        const QJsonDocument doc = QJsonDocument::fromJson(body);
+        if (doc.isObject()) handleMessage(doc.object());
+    }
+}
+
+void LspClient::handleMessage(const QJsonObject &message) {
+    if (message.contains("id") && !message.contains("method")) {
+        // Respuesta: las canceladas ya no tienen handler y se descartan
+        const ResponseHandler handler = m_pending.take(message.value("id").toInt());
+        if (handler && !message.contains("error"))
+            handler(message.value("result").toObject());
+        return;
+    }
+
+    const QString method = message.value("method").toString();
+    if (method == "textDocument/publishDiagnostics")
+        publishDiagnostics(message.value("params").toObject());
+    else if (message.contains("id")) {
+        // Peticiones del servidor (p. ej. workDoneProgress/create): respuesta vacía
+        write(QJsonObject{{"jsonrpc", "2.0"}, {"id", message.value("id")}, {"result", QJsonValue()}});
+    }
+}
+
+void LspClient::publishDiagnostics(const QJsonObject &params) {
+    const QString filePath = QUrl(params.value("uri").toString()).toLocalFile();
+    QVector<Diagnostic> diagnostics;
+    for (const QJsonValue &v : params.value("diagnostics").toArray()) {
+        const QJsonObject d = v.toObject();
+        const QJsonObject range = d.value("range").toObject();
+        const QJsonObject start = range.value("start").toObject();
+        const QJsonObject end = range.value("end").toObject();
+        Diagnostic diag;
+        diag.file = filePath;
+        diag.line = start.value("line").toInt();
+        diag.column = start.value("character").toInt();
+        diag.endLine = end.value("line").toInt();
+        diag.endColumn = end.value("character").toInt();
+        diag.severity = static_cast<Diagnostic::Severity>(d.value("severity").toInt(Diagnostic::Error));
+        diag.message = d.value("message").toString();
+        diag.source = QStringLiteral("clangd");
+        diagnostics.append(diag);
+    }
+    emit diagnosticsPublished(filePath, diagnostics);
+}
+
+void LspClient::onFinished(int, QProcess::ExitStatus) {
+    m_initialized = false;
+    m_pending.clear();
+    m_queued.clear();
+    m_versions.clear();
+}
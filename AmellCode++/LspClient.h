@@ -0,0 +1,65 @@
+#pragma once
+
+#include "BlockData.h"
+#include "Diagnostic.h"
+
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+#include <functional>
+
+// Cliente LSP mínimo contra un proceso clangd local (JSON-RPC sobre stdio).
+// Todo es asíncrono: las peticiones devuelven un id que se puede cancelar y
+// las respuestas llegan en el bucle de eventos, nunca bloquean al editor.
+class LspClient : public QObject {
+    Q_OBJECT
+public:
+    using TokensHandler = std::function<void(const QVector<SemanticToken> &)>;
+
+    explicit LspClient(QObject *parent = nullptr);
+    ~LspClient() override;
+
+    bool start(const QString &rootPath);
+    bool isRunning() const;
+
+    void didOpen(const QString &filePath, const QString &text);
+    void didClose(const QString &filePath);
+    void didSave(const QString &filePath);
+    // Reemplaza el rango [(startLine, startCharacter), (endLine, endCharacter)) por 'text'
+    void didChange(const QString &filePath, int startLine, int startCharacter,
+                   int endLine, int endCharacter, const QString &text);
+
+    // Tokens semánticos de las líneas [startLine, endLine); 'context' protege el callback
+    int requestSemanticTokens(const QString &filePath, int startLine, int endLine,
+                              QObject *context, TokensHandler handler);
+    void cancel(int requestId);
+
+signals:
+    void diagnosticsPublished(const QString &filePath, const QVector<Diagnostic> &diagnostics);
+
+private slots:
+    void onReadyRead();
+    void onFinished(int exitCode, QProcess::ExitStatus status);
+
+private:
+    using ResponseHandler = std::function<void(const QJsonObject &result)>;
+
+    int sendRequest(const QString &method, const QJsonObject &params, ResponseHandler handler);
+    void sendNotification(const QString &method, const QJsonObject &params);
+    void write(const QJsonObject &message);
+    void handleMessage(const QJsonObject &message);
+    void handleInitialized(const QJsonObject &result);
+    void publishDiagnostics(const QJsonObject &params);
+    SemanticToken::Kind kindForType(int typeIndex) const;
+
+    QProcess *m_process;
+    QByteArray m_buffer;
+    int m_nextId = 1;
+    bool m_initialized = false;
+    QVector<QJsonObject> m_queued;            // mensajes previos a 'initialized'
+    QHash<int, ResponseHandler> m_pending;
+    QHash<QString, int> m_versions;           // ruta -> versión del documento
+    QStringList m_tokenTypes;                 // leyenda de semanticTokens
+};
@@ -1,7 +1,25 @@
 #include "MainWindow.h"
-#include "Editor.h"
+#include "BuildOutputView.h"
+#include "BuildTimeline.h"
+#include "CMakeProject.h"
+#include "CompileCache.h"
+#include "CompileCommands.h"
+#include "CompilerOutputParser.h"
+#include "DocumentTabs.h"
+#include "CompletionIndex.h"
+#include "CppHighlighter.h"
+#include "HexView.h"
+#include "LspClient.h"
+#include "NinjaLog.h"
+#include "ProblemsView.h"
+#include "SyntaxChecker.h"
+#include "TargetsView.h"
+#include "TimeTrace.h"
+#include "TimeTraceView.h"
 
 #include <QApplication>
+#include <QCloseEvent>
+#include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QFileSystemModel>
@@ -10,31 +28,95 @@
 #include <QToolBar>
 #include <QTreeView>
 #include <QDockWidget>
-#include <QProcess>
-#include <QMessageBox>
 #include <QDir>
 #include <QColor>
 #include <QPalette>
 #include <QAction>
 #include <QKeySequence>
+#include <QThread>
+#include <QThreadPool>
+#include <QPointer>
+#include <QProcess>
+#include <QScrollArea>
+#include <QSettings>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
-      m_editor(new Editor(this)),
+      m_tabs(new DocumentTabs(this)),
       m_projectTree(nullptr),
       m_fsModel(nullptr),
-      m_buildProcess(nullptr) {
+      m_targets(nullptr),
+      m_scheduler(new BuildScheduler(this)),
+      m_buildOutput(nullptr),
+      m_buildDock(nullptr),
+      m_problems(nullptr),
+      m_problemsDock(nullptr),
+      m_timeTrace(nullptr),
+      m_timeTraceDock(nullptr),
+      m_timeline(nullptr),
+      m_timelineDock(nullptr),
+      m_parserThread(new QThread(this)),
+      m_parser(new CompilerOutputParser),
+      m_lspClient(new LspClient(this)),
+      m_cmake(std::make_unique<CMakeProject>(QDir::currentPath(), QDir::currentPath() + "/build")),
+      m_compileCommands(std::make_unique<CompileCommands>(m_cmake->buildDir())),
+      m_syntaxChecker(new SyntaxChecker(m_scheduler, m_compileCommands.get(), this)) {
     setWindowTitle("AMELL-IDE");
-    setCentralWidget(m_editor);
+    setCentralWidget(m_tabs);
     resize(1100, 700);
 
+    // El parser de diagnósticos trabaja en su hilo; los lotes vuelven en cola
+    qRegisterMetaType<QVector<Diagnostic>>();
+    m_parser->moveToThread(m_parserThread);
+    connect(m_parserThread, &QThread::finished, m_parser, &QObject::deleteLater);
+    connect(m_parser, &CompilerOutputParser::parsed, this, &MainWindow::onDiagnosticsParsed);
+    m_parserThread->start();
+
+    applyCompileCacheSetting();
+    m_cmake->setTimeTrace(QSettings().value(QStringLiteral("build/timeTrace"), false).toBool());
+    connect(m_scheduler, &BuildScheduler::jobStarted, this, &MainWindow::onJobStarted);
+    connect(m_scheduler, &BuildScheduler::jobOutput, this, &MainWindow::onJobOutput);
+    connect(m_scheduler, &BuildScheduler::jobFinished, this, &MainWindow::onJobFinished);
+
+    connect(m_tabs, &DocumentTabs::currentDocumentChanged, m_syntaxChecker, &SyntaxChecker::setDocument);
+    connect(m_syntaxChecker, &SyntaxChecker::diagnosticsReady, this,
+            [this](const QString &, const QVector<Diagnostic> &diagnostics) {
+        m_tabs->clearDiagnostics(QStringLiteral("syntax"));
+        m_tabs->addDiagnostics(QStringLiteral("syntax"), diagnostics);
+    });
+    m_syntaxChecker->setDocument(m_tabs->currentDocument());
+    connect(m_compileCommands.get(), &CompileCommands::loaded, this, [this](int entries, int reused, qint64 ms) {
+        statusBar()->showMessage(tr("compile_commands.json: %1 entradas (%2 sin cambios) en %3 ms")
+                                 .arg(entries).arg(reused).arg(ms), 4000);
+    });
+    m_compileCommands->reload();
+
     createMenus();
     createToolbar();
     createDocks();
     applyBluePalette();
+
+    CompletionIndex::instance().indexWorkspace(QDir::currentPath());
+    loadCodeModel();
+
+    // Métrica de arranque: las reglas se compilan una vez para todos los documentos
+    statusBar()->showMessage(tr("Reglas de resaltado compiladas en %1 ms")
+                             .arg(CppHighlighter::ruleSet().buildTimeNs / 1e6, 0, 'f', 2), 4000);
+
+    // clangd es opcional: sin él se queda el resaltado léxico
+    if (m_lspClient->start(QDir::currentPath()))
+        m_tabs->setLanguageClient(m_lspClient);
 }
 
-MainWindow::~MainWindow() {}
+MainWindow::~MainWindow() {
+    m_parserThread->quit();
+    m_parserThread->wait();
+}
+
+void MainWindow::closeEvent(QCloseEvent *event) {
+    if (m_tabs->closeAll()) event->accept();
+    else event->ignore();
+}
 
 void MainWindow::createMenus() {
     auto fileMenu = menuBar()->addMenu(tr("File"));
@@ -61,6 +143,13 @@ void MainWindow::createMenus() {
     connect(actSave, &QAction::triggered, this, &MainWindow::saveFile);
     fileMenu->addAction(actSave);
 
+    QAction *actClose = new QAction(tr("Cerrar pestaña"), this);
+    actClose->setObjectName("actionClose");
+    actClose->setShortcut(QKeySequence::Close); // Ctrl+W
+    actClose->setShortcutContext(Qt::ApplicationShortcut);
+    connect(actClose, &QAction::triggered, this, [this]() { m_tabs->closeTab(m_tabs->currentIndex()); });
+    fileMenu->addAction(actClose);
+
     fileMenu->addSeparator();
 
     QAction *actQuit = new QAction(tr("Salir"), this);
@@ -70,6 +159,40 @@ void MainWindow::createMenus() {
     connect(actQuit, &QAction::triggered, this, &QWidget::close);
     fileMenu->addAction(actQuit);
 
+    auto viewMenu = menuBar()->addMenu(tr("Ver"));
+
+    QAction *actSplitRight = new QAction(tr("Dividir a la derecha"), this);
+    actSplitRight->setObjectName("actionSplitRight");
+    connect(actSplitRight, &QAction::triggered, this, [this]() { m_tabs->split(Qt::Horizontal); });
+    viewMenu->addAction(actSplitRight);
+
+    QAction *actSplitDown = new QAction(tr("Dividir abajo"), this);
+    actSplitDown->setObjectName("actionSplitDown");
+    connect(actSplitDown, &QAction::triggered, this, [this]() { m_tabs->split(Qt::Vertical); });
+    viewMenu->addAction(actSplitDown);
+
+    QAction *actUnsplit = new QAction(tr("Quitar división"), this);
+    actUnsplit->setObjectName("actionUnsplit");
+    connect(actUnsplit, &QAction::triggered, this, [this]() { m_tabs->unsplit(); });
+    viewMenu->addAction(actUnsplit);
+
+    viewMenu->addSeparator();
+
+    QAction *actTail = new QAction(tr("Seguir el final del fichero"), this);
+    actTail->setObjectName("actionTail");
+    actTail->setCheckable(true);
+    connect(actTail, &QAction::triggered, this, [this, actTail](bool checked) {
+        if (!m_tabs->currentDocument()->setTailMode(checked)) {
+            actTail->setChecked(false);
+            statusBar()->showMessage(tr("Guarda el fichero antes de seguir su final"), 4000);
+        }
+    });
+    // El estado es de cada documento: se refresca al abrir el menú
+    connect(viewMenu, &QMenu::aboutToShow, this, [this, actTail]() {
+        actTail->setChecked(m_tabs->currentDocument()->isTailing());
+    });
+    viewMenu->addAction(actTail);
+
     auto buildMenu = menuBar()->addMenu(tr("Build"));
 
     QAction *actBuild = new QAction(tr("Compilar"), this);
@@ -85,6 +208,42 @@ void MainWindow::createMenus() {
     actRun->setShortcutContext(Qt::ApplicationShortcut);
     connect(actRun, &QAction::triggered, this, &MainWindow::runProject);
     buildMenu->addAction(actRun);
+
+    QAction *actTest = new QAction(tr("Probar"), this);
+    actTest->setObjectName("actionTest");
+    actTest->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_T)); // Ctrl+Shift+T
+    actTest->setShortcutContext(Qt::ApplicationShortcut);
+    connect(actTest, &QAction::triggered, this, &MainWindow::testProject);
+    buildMenu->addAction(actTest);
+
+    QAction *actCache = new QAction(tr("Usar caché de compilación"), this);
+    actCache->setObjectName("actionCompileCache");
+    actCache->setCheckable(true);
+    actCache->setChecked(QSettings().value(QStringLiteral("build/compileCache"), false).toBool());
+    connect(actCache, &QAction::toggled, this, [this](bool checked) {
+        QSettings().setValue(QStringLiteral("build/compileCache"), checked);
+        applyCompileCacheSetting();
+    });
+    buildMenu->addAction(actCache);
+
+    QAction *actTimeTrace = new QAction(tr("Perfilar tiempos de compilación"), this);
+    actTimeTrace->setObjectName("actionTimeTrace");
+    actTimeTrace->setCheckable(true);
+    actTimeTrace->setChecked(QSettings().value(QStringLiteral("build/timeTrace"), false).toBool());
+    connect(actTimeTrace, &QAction::toggled, this, [this](bool checked) {
+        QSettings().setValue(QStringLiteral("build/timeTrace"), checked);
+        m_cmake->setTimeTrace(checked);
+    });
+    buildMenu->addAction(actTimeTrace);
+
+    buildMenu->addSeparator();
+
+    QAction *actCancel = new QAction(tr("Cancelar tareas"), this);
+    actCancel->setObjectName("actionCancelJobs");
+    actCancel->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_Pause));
+    actCancel->setShortcutContext(Qt::ApplicationShortcut);
+    connect(actCancel, &QAction::triggered, m_scheduler, &BuildScheduler::cancelAll);
+    buildMenu->addAction(actCancel);
 }
 
 void MainWindow::createToolbar() {
@@ -135,9 +294,61 @@ void MainWindow::createDocks() {
     m_projectTree = new QTreeView(this);
     m_projectTree->setModel(m_fsModel);
     m_projectTree->setRootIndex(m_fsModel->index(QDir::currentPath()));
+    connect(m_projectTree, &QTreeView::doubleClicked, this, [this](const QModelIndex &index) {
+        if (!m_fsModel->isDir(index)) openPath(m_fsModel->filePath(index));
+    });
     auto dock = new QDockWidget(tr("Proyecto"), this);
     dock->setWidget(m_projectTree);
     addDockWidget(Qt::LeftDockWidgetArea, dock);
+
+    m_targets = new TargetsView(this);
+    auto targetsDock = new QDockWidget(tr("Objetivos"), this);
+    targetsDock->setObjectName("targetsDock");
+    targetsDock->setWidget(m_targets);
+    tabifyDockWidget(dock, targetsDock);
+    dock->raise();
+    connect(m_targets, &TargetsView::fileActivated, this, &MainWindow::openPath);
+
+    m_buildOutput = new BuildOutputView(this);
+    m_buildDock = new QDockWidget(tr("Salida de compilación"), this);
+    m_buildDock->setObjectName("buildOutputDock");
+    m_buildDock->setWidget(m_buildOutput);
+    addDockWidget(Qt::BottomDockWidgetArea, m_buildDock);
+    m_outputDocks.insert(QStringLiteral("build"), m_buildDock);
+
+    m_problems = new ProblemsView(this);
+    m_problemsDock = new QDockWidget(tr("Problemas"), this);
+    m_problemsDock->setObjectName("problemsDock");
+    m_problemsDock->setWidget(m_problems);
+    tabifyDockWidget(m_buildDock, m_problemsDock);
+    connect(m_problems, &ProblemsView::problemActivated, this, [this](const Diagnostic &d) {
+        openPath(d.file);
+        m_tabs->editor()->goToLine(d.line, d.column);
+    });
+
+    m_timeTrace = new TimeTraceView(this);
+    m_timeTraceDock = new QDockWidget(tr("Tiempos de compilación"), this);
+    m_timeTraceDock->setObjectName("timeTraceDock");
+    m_timeTraceDock->setWidget(m_timeTrace);
+    tabifyDockWidget(m_buildDock, m_timeTraceDock);
+    connect(m_timeTrace, &TimeTraceView::locationActivated, this, [this](const QString &file, int line) {
+        openPath(file);
+        m_tabs->editor()->goToLine(line, 0);
+    });
+
+    m_timeline = new BuildTimeline;
+    auto timelineScroll = new QScrollArea;
+    timelineScroll->setWidgetResizable(true);
+    timelineScroll->setWidget(m_timeline);
+    m_timelineDock = new QDockWidget(tr("Cronología de compilación"), this);
+    m_timelineDock->setObjectName("timelineDock");
+    m_timelineDock->setWidget(timelineScroll);
+    tabifyDockWidget(m_buildDock, m_timelineDock);
+
+    m_buildDock->hide();
+    m_problemsDock->hide();
+    m_timeTraceDock->hide();
+    m_timelineDock->hide();
 }
 
 void MainWindow::applyBluePalette() {
@@ -166,7 +377,7 @@ void MainWindow::applyBluePalette() {
 }
 
 void MainWindow::newFile() {
-    m_editor->newDocument();
+    m_tabs->newDocument();
 }
 
 void MainWindow::openFile() {
@@ -174,69 +385,304 @@ void MainWindow::openFile() {
         this, tr("Open File"), QDir::currentPath(),
         tr("C/C++ Files (*.h *.hpp *.c *.cpp);;All Files (*.*)"));
     if (!file.isEmpty()) {
-        m_editor->openFile(file);
+        openPath(file);
     }
 }
 
+void MainWindow::openPath(const QString &filePath) {
+    if (!HexView::isBinary(filePath)) {
+        m_tabs->openFile(filePath);
+        return;
+    }
+    auto view = new HexView;
+    if (!view->open(filePath)) {
+        delete view;
+        return;
+    }
+    auto dock = new QDockWidget(tr("%1 (hex)").arg(QFileInfo(filePath).fileName()), this);
+    dock->setAttribute(Qt::WA_DeleteOnClose);
+    dock->setWidget(view);
+    connect(view, &HexView::searchFinished, this, [this](bool found) {
+        if (!found) statusBar()->showMessage(tr("Patrón no encontrado"), 4000);
+    });
+    addDockWidget(Qt::RightDockWidgetArea, dock);
+    view->setFocus();
+}
+
 void MainWindow::saveFile() {
-    m_editor->save();
+    m_tabs->save();
 }
 
-void MainWindow::buildProject() {
-    if (m_buildProcess) {
-        m_buildProcess->kill();
-        m_buildProcess->deleteLater();
-    }
-    m_buildProcess = new QProcess(this);
-    connect(m_buildProcess, &QProcess::readyReadStandardOutput, this, &MainWindow::onBuildReadyRead);
-    connect(m_buildProcess, &QProcess::readyReadStandardError, this, &MainWindow::onBuildReadyRead);
-    connect(m_buildProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &MainWindow::onBuildFinished);
+BuildOutputView *MainWindow::outputPane(const QString &pane) {
+    if (QDockWidget *dock = m_outputDocks.value(pane))
+        return static_cast<BuildOutputView *>(dock->widget());
+    const QString title = pane == QLatin1String("run") ? tr("Ejecución")
+                        : pane == QLatin1String("test") ? tr("Pruebas")
+                        : pane;
+    auto dock = new QDockWidget(title, this);
+    dock->setObjectName(pane + QStringLiteral("OutputDock"));
+    dock->setWidget(new BuildOutputView(dock));
+    tabifyDockWidget(m_buildDock, dock);
+    m_outputDocks.insert(pane, dock);
+    return static_cast<BuildOutputView *>(dock->widget());
+}
+
+// ---------- Tareas ----------
+// Configurar, compilar y probar comparten el directorio de compilación y se
+// serializan; ejecutar solo espera a que la compilación acabe bien. Repetir
+// una orden sustituye a la que aún esté en cola sin matar la que corre.
 
-    const QString buildDir = QDir::currentPath() + "/build";
+int MainWindow::submitBuild(const QString &target) {
+    const QString buildDir = m_cmake->buildDir();
     if (!QDir(buildDir).exists()) {
         QDir().mkpath(buildDir);
     }
+    m_cmake->writeFileApiQuery();
+
+    BuildScheduler::Job configure;
+    configure.key = QStringLiteral("configure");
+    configure.title = tr("Configuración de CMake");
+    configure.pane = QStringLiteral("build");
+    configure.resource = buildDir;
+    configure.program = QStringLiteral("cmake");
+    configure.arguments = m_cmake->configureArguments();
+    configure.workingDirectory = m_cmake->sourceDir();
+    // Con el árbol ya configurado y sin cambios en sus entradas se salta
+    configure.condition = [this]() { return m_cmake->needsConfigure(); };
+    configure.onSuccess = [this]() {
+        m_cmake->markConfigured();
+        loadCodeModel();
+        m_compileCommands->reload();
+    };
+    const int configureId = m_scheduler->submit(configure);
+
+    BuildScheduler::Job build;
+    build.key = QStringLiteral("build");
+    build.title = target.isEmpty() ? tr("Compilación") : tr("Compilación de %1").arg(target);
+    build.pane = QStringLiteral("build");
+    build.resource = buildDir;
+    build.program = QStringLiteral("cmake");
+    build.arguments = m_cmake->buildArguments(target);
+    build.workingDirectory = m_cmake->sourceDir();
+    build.dependencies = {configureId};
+    if (QSettings().value(QStringLiteral("build/compileCache"), false).toBool()) {
+        build.environment = QProcessEnvironment::systemEnvironment();
+        build.environment.insert(QLatin1String(CompileCache::STATS_ENV), compileCacheStatsPath());
+    }
+    return m_scheduler->submit(build);
+}
 
-    QProcess *configure = new QProcess(this);
-    configure->setProgram("cmake");
-    configure->setArguments(QStringList() << "-S" << "." << "-B" << buildDir);
-    configure->setWorkingDirectory(QDir::currentPath());
-    connect(configure, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [this, buildDir](int code, QProcess::ExitStatus st) {
-                if (st != QProcess::NormalExit || code != 0) {
-                    statusBar()->showMessage(tr("CMake configure failed"), 6000);
-                    return;
-                }
-                m_buildProcess->setProgram("cmake");
-                m_buildProcess->setArguments(QStringList() << "--build" << buildDir);
-                m_buildProcess->setWorkingDirectory(QDir::currentPath());
-                m_buildProcess->start();
-            });
-    configure->start();
+void MainWindow::buildProject() {
+    submitBuild(m_targets->currentTarget());
 }
 
+// Se ejecuta el objetivo seleccionado si es un ejecutable; si no, el
+// primero que lo sea. Antes se compila solo ese objetivo.
 void MainWindow::runProject() {
-    QString exePath = QDir::currentPath() + "/build/Amell-IDE";
-#ifdef Q_OS_WIN
-    exePath += ".exe";
-#endif
-    if (!QFileInfo::exists(exePath)) {
-        QMessageBox::warning(this, tr("Ejecutar"), tr("Ejecutable no encontrado. Compila primero."));
+    const CMakeTarget *target = m_cmake->target(m_targets->currentTarget());
+    if (!target || !target->isExecutable() || target->artifacts.isEmpty()) {
+        target = nullptr;
+        for (const CMakeTarget &t : m_cmake->targets()) {
+            if (t.isExecutable() && !t.artifacts.isEmpty()) {
+                target = &t;
+                break;
+            }
+        }
+    }
+    if (!target) {
+        statusBar()->showMessage(tr("No hay ningún ejecutable en el proyecto. Compila primero."), 6000);
+        if (m_cmake->targets().isEmpty()) submitBuild();
         return;
     }
-    QProcess::startDetached(exePath);
+
+    BuildScheduler::Job run;
+    run.key = QStringLiteral("run");
+    run.title = tr("Ejecución de %1").arg(target->name);
+    run.pane = QStringLiteral("run");
+    run.program = target->artifacts.first();
+    run.workingDirectory = QFileInfo(run.program).absolutePath();
+    run.dependencies = {submitBuild(target->name)};
+    m_scheduler->submit(run);
+}
+
+// El cambio entra en la huella de la configuración: la próxima compilación reconfigura
+void MainWindow::applyCompileCacheSetting() {
+    QStringList launcher;
+    if (QSettings().value(QStringLiteral("build/compileCache"), false).toBool())
+        launcher << QCoreApplication::applicationFilePath() << QLatin1String(CompileCache::LAUNCHER_FLAG);
+    m_cmake->setCompilerLauncher(launcher);
+}
+
+QString MainWindow::compileCacheStatsPath() const {
+    return m_cmake->buildDir() + "/.amellide/compile-cache.stats";
+}
+
+void MainWindow::analyzeTimeTrace() {
+    const QString buildDir = m_cmake->buildDir();
+    const QByteArray log = m_buildLog;
+    QPointer<MainWindow> guard(this);
+    QThreadPool::globalInstance()->start([guard, buildDir, log]() {
+        const QStringList traces = TimeTrace::findTraces(buildDir);
+        QVector<TimeTraceItem> items = TimeTrace::aggregateClang(traces);
+        items += TimeTrace::aggregateGccReport(log);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, items, count = int(traces.size())]() {
+            if (!guard) return;
+            guard->m_timeTrace->setItems(items);
+            guard->m_timeTraceDock->show();
+            guard->statusBar()->showMessage(tr("Perfil de compilación: %1 trazas de Clang").arg(count), 4000);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::analyzeNinjaLog() {
+    const QString logPath = m_cmake->buildDir() + "/.ninja_log";
+    if (!QFileInfo::exists(logPath)) return;
+    // Ninja solo añade al registro: si no creció no se recompiló nada
+    if (QFileInfo(logPath).size() == m_ninjaLogSize) {
+        NinjaBuildAnalysis upToDate;
+        upToDate.upToDate = true;
+        m_timeline->setAnalysis(upToDate);
+        return;
+    }
+    const QString ninja = m_cmake->makeProgram();
+    const QString buildDir = m_cmake->buildDir();
+    QPointer<MainWindow> guard(this);
+    QThreadPool::globalInstance()->start([guard, logPath, ninja, buildDir]() {
+        QProcess graph;
+        graph.start(ninja, {"-C", buildDir, "-t", "graph"});
+        QHash<QString, QStringList> inputs;
+        if (graph.waitForFinished(30000) && graph.exitCode() == 0)
+            inputs = NinjaLog::parseGraph(graph.readAllStandardOutput());
+        const NinjaBuildAnalysis analysis = NinjaLog::analyze(logPath, inputs);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, analysis]() {
+            if (!guard || analysis.isEmpty()) return;
+            guard->m_timeline->setAnalysis(analysis);
+            guard->m_timelineDock->show();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::loadCodeModel() {
+    const QString index = m_cmake->replyIndexPath();
+    if (index.isEmpty() || index == m_cmake->codeModelIndex()) return;
+    const QString sourceDir = m_cmake->sourceDir();
+    const QString buildDir = m_cmake->buildDir();
+    QPointer<MainWindow> guard(this);
+    QThreadPool::globalInstance()->start([guard, index, sourceDir, buildDir]() {
+        const QVector<CMakeTarget> targets = CMakeProject::readCodeModel(index, sourceDir, buildDir);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, index, targets]() {
+            if (!guard) return;
+            guard->m_cmake->setCodeModel(index, targets);
+            guard->m_targets->setTargets(targets);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::testProject() {
+    BuildScheduler::Job test;
+    test.key = QStringLiteral("test");
+    test.title = tr("Pruebas");
+    test.pane = QStringLiteral("test");
+    test.resource = m_cmake->buildDir();
+    test.program = QStringLiteral("ctest");
+    test.arguments = {QStringLiteral("--test-dir"), m_cmake->buildDir(),
+                      QStringLiteral("--output-on-failure"),
+                      QStringLiteral("-j%1").arg(QThread::idealThreadCount())};
+    test.workingDirectory = m_cmake->buildDir();
+    test.dependencies = {submitBuild()};
+    m_scheduler->submit(test);
+}
+
+// Las tareas sin panel (comprobación de sintaxis) no se muestran
+void MainWindow::onJobStarted(int id) {
+    const BuildScheduler::Job *job = m_scheduler->job(id);
+    if (job->pane.isEmpty()) return;
+    // Cada cadena de compilación empieza por configurar (aunque se salte):
+    // ahí se limpian el panel, los problemas y el parser
+    if (job->key == QLatin1String("configure")) {
+        m_buildOutput->clear();
+        m_buildLog.clear();
+        m_problems->clearDiagnostics();
+        m_problemsDock->setWindowTitle(tr("Problemas"));
+        m_tabs->clearDiagnostics(QStringLiteral("build"));
+        m_problemsDock->show();
+        const QString buildDir = m_cmake->buildDir();
+        QMetaObject::invokeMethod(m_parser, [parser = m_parser, buildDir]() { parser->reset(buildDir); }, Qt::QueuedConnection);
+    } else if (job->key == QLatin1String("build")) {
+        const QFileInfo ninjaLog(m_cmake->buildDir() + "/.ninja_log");
+        m_ninjaLogSize = ninjaLog.exists() ? ninjaLog.size() : -1;
+        QDir().mkpath(QFileInfo(compileCacheStatsPath()).absolutePath());
+        QFile::remove(compileCacheStatsPath());
+    } else if (job->pane != QLatin1String("build")) {
+        outputPane(job->pane)->clear();
+    }
+    QDockWidget *dock = m_outputDocks.value(job->pane);
+    dock->show();
+    dock->raise();
 }
 
-void MainWindow::onBuildReadyRead() {
-    const QByteArray out = m_buildProcess->readAllStandardOutput() + m_buildProcess->readAllStandardError();
-    statusBar()->showMessage(QString::fromLocal8Bit(out));
+void MainWindow::onJobOutput(int id, const QByteArray &bytes) {
+    const BuildScheduler::Job *job = m_scheduler->job(id);
+    if (job->pane.isEmpty()) return;
+    if (job->pane == QLatin1String("build")) handleBuildOutput(bytes);
+    else outputPane(job->pane)->append(bytes);
 }
 
-void MainWindow::onBuildFinished(int exitCode, QProcess::ExitStatus status) {
-    if (status == QProcess::NormalExit && exitCode == 0) {
-        statusBar()->showMessage(tr("Compilación exitosa"), 4000);
-    } else {
-        statusBar()->showMessage(tr("Compilación fallida"), 6000);
+// Aquí solo se copian bytes: BuildOutputView los trocea una vez por
+// fotograma y el parser los analiza en su hilo
+void MainWindow::handleBuildOutput(const QByteArray &bytes) {
+    if (bytes.isEmpty()) return;
+    m_buildOutput->append(bytes);
+    if (m_cmake->timeTrace() && m_buildLog.size() < MAX_BUILD_LOG) m_buildLog += bytes;
+    QMetaObject::invokeMethod(m_parser, [parser = m_parser, bytes]() { parser->feed(bytes); }, Qt::QueuedConnection);
+}
+
+void MainWindow::onDiagnosticsParsed(const QVector<Diagnostic> &diagnostics) {
+    const QVector<Diagnostic> added = m_problems->addDiagnostics(diagnostics);
+    if (added.isEmpty()) return;
+    m_tabs->addDiagnostics(QStringLiteral("build"), added);
+    m_problemsDock->setWindowTitle(tr("Problemas (%1 errores, %2 advertencias)")
+                                   .arg(m_problems->errorCount()).arg(m_problems->warningCount()));
+}
+
+void MainWindow::onJobFinished(int id, BuildScheduler::State state, qint64 elapsedMs, bool skipped) {
+    const BuildScheduler::Job *job = m_scheduler->job(id);
+    if (skipped || job->pane.isEmpty()) return;
+    // La última línea sin '\n' de una tarea no debe pegarse a la primera
+    // de la siguiente: el parser se cierra al final de cada tarea del panel
+    // y la línea de estado de abajo cierra la del BuildOutputView
+    if (job->pane == QLatin1String("build"))
+        QMetaObject::invokeMethod(m_parser, [parser = m_parser]() { parser->finish(); }, Qt::QueuedConnection);
+    if (job->key == QLatin1String("build")) {
+        if (!job->environment.isEmpty()) {
+            const CompileCache::Stats stats = CompileCache::readStats(compileCacheStatsPath());
+            if (stats.total() > 0) {
+                m_buildOutput->appendLine(tr("== Caché de compilación: %1 aciertos, %2 fallos, %3 sin caché ==")
+                                          .arg(stats.hits).arg(stats.misses).arg(stats.uncacheable));
+            }
+            const QString dir = CompileCache::directory();
+            const qint64 max = CompileCache::maxBytes();
+            QThreadPool::globalInstance()->start([dir, max]() { CompileCache::evict(dir, max); });
+        }
+        if (m_cmake->timeTrace() && state != BuildScheduler::Cancelled) analyzeTimeTrace();
+        if (state != BuildScheduler::Cancelled) analyzeNinjaLog();
+    }
+
+    const QString seconds = QString::number(elapsedMs / 1000.0, 'f', 1);
+    QString message;
+    switch (state) {
+    case BuildScheduler::Succeeded:
+        message = tr("%1: terminada en %2 s").arg(job->title, seconds);
+        break;
+    case BuildScheduler::Failed:
+        message = tr("%1: fallida tras %2 s").arg(job->title, seconds);
+        break;
+    case BuildScheduler::Cancelled:
+        message = tr("%1: cancelada").arg(job->title);
+        break;
+    default:
+        return;
     }
+    outputPane(job->pane)->appendLine(QStringLiteral("== %1 ==").arg(message));
+    statusBar()->showMessage(message, state == BuildScheduler::Succeeded ? 4000 : 6000);
 }
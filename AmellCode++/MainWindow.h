@@ -1,9 +1,26 @@
 #pragma once
 
+#include <QHash>
 #include <QMainWindow>
-#include <QProcess>
 
-class Editor;
+#include "BuildScheduler.h"
+#include "Diagnostic.h"
+
+#include <memory>
+
+class BuildOutputView;
+class BuildTimeline;
+class CMakeProject;
+class CompileCommands;
+class CompilerOutputParser;
+class DocumentTabs;
+class LspClient;
+class ProblemsView;
+class SyntaxChecker;
+class TargetsView;
+class TimeTraceView;
+class QDockWidget;
+class QThread;
 class QTreeView;
 class QFileSystemModel;
 
@@ -13,23 +30,67 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override;
 
+    static constexpr qsizetype MAX_BUILD_LOG = 64 * 1024 * 1024;
+
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
 private slots:
     void newFile();
     void openFile();
     void saveFile();
     void buildProject();
     void runProject();
-    void onBuildReadyRead();
-    void onBuildFinished(int exitCode, QProcess::ExitStatus status);
+    void testProject();
+    void onJobStarted(int id);
+    void onJobOutput(int id, const QByteArray &bytes);
+    void onJobFinished(int id, BuildScheduler::State state, qint64 elapsedMs, bool skipped);
+    void onDiagnosticsParsed(const QVector<Diagnostic> &diagnostics);
 
 private:
     void createMenus();
     void createToolbar();
     void createDocks();
+    // Los binarios se abren en una vista hexadecimal en lugar de una pestaña
+    void openPath(const QString &filePath);
+    // Encola configurar (si hace falta) y compilar; devuelve la tarea de compilación
+    // (solo 'target' si no está vacío)
+    int submitBuild(const QString &target = QString());
+    // Relee los objetivos en el pool si la respuesta de la File API cambió
+    void loadCodeModel();
+    // Activa o quita el lanzador de la caché de compilación en la configuración
+    void applyCompileCacheSetting();
+    QString compileCacheStatsPath() const;
+    // Junta en el pool las trazas de la última compilación en modo perfil
+    void analyzeTimeTrace();
+    // Camino crítico y paralelismo de la última compilación según .ninja_log
+    void analyzeNinjaLog();
+    // Panel de salida de cada tipo de tarea; se crea al primer uso
+    BuildOutputView *outputPane(const QString &pane);
+    // Reparte la salida de la compilación entre el panel y el parser
+    void handleBuildOutput(const QByteArray &bytes);
     void applyBluePalette();
 
-    Editor *m_editor;
+    DocumentTabs *m_tabs;
     QTreeView *m_projectTree;
     QFileSystemModel *m_fsModel;
-    QProcess *m_buildProcess;
+    TargetsView *m_targets;
+    BuildScheduler *m_scheduler;
+    BuildOutputView *m_buildOutput;
+    QDockWidget *m_buildDock;
+    QHash<QString, QDockWidget *> m_outputDocks;
+    ProblemsView *m_problems;
+    QDockWidget *m_problemsDock;
+    TimeTraceView *m_timeTrace;
+    QDockWidget *m_timeTraceDock;
+    BuildTimeline *m_timeline;
+    QDockWidget *m_timelineDock;
+    qint64 m_ninjaLogSize = -1;       // tamaño de .ninja_log al empezar la compilación
+    QByteArray m_buildLog;            // salida de la compilación en modo perfil (GCC)
+    QThread *m_parserThread;
+    CompilerOutputParser *m_parser;   // vive en m_parserThread
+    LspClient *m_lspClient;
+    std::unique_ptr<CMakeProject> m_cmake;
+    std::unique_ptr<CompileCommands> m_compileCommands;
+    SyntaxChecker *m_syntaxChecker;
 };
@@ -0,0 +1,175 @@
+#include "Minimap.h"
+#include "CppHighlighter.h"
+#include "Document.h"
+#include "Editor.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QTextLayout>
+#include <QVarLengthArray>
+
+#include <cmath>
+
+Minimap::Minimap(Editor *editor)
+    : QWidget(editor),
+      m_editor(editor) {
+    m_tiles.setMaxCost(16 * 1024);
+    setCursor(Qt::ArrowCursor);
+}
+
+void Minimap::setDocument(Document *document) {
+    for (const QMetaObject::Connection &c : std::as_const(m_connections)) disconnect(c);
+    m_connections.clear();
+    m_tiles.clear();
+
+    m_document = document;
+    m_blockCount = document->textDocument()->blockCount();
+    m_connections << connect(document->textDocument(), &QTextDocument::contentsChange, this, &Minimap::onContentsChange)
+                  << connect(document->highlighter(), &CppHighlighter::blockHighlighted, this, [this](int blockNumber) {
+        invalidateTile(blockNumber / TILE_LINES);
+    });
+    update();
+}
+
+// ---------- Invalidación ----------
+
+void Minimap::onContentsChange(int position, int charsRemoved, int charsAdded) {
+    Q_UNUSED(charsRemoved);
+    const QTextDocument *doc = m_document->textDocument();
+    const int first = doc->findBlock(position).blockNumber();
+    const int last = doc->findBlock(qMin(position + charsAdded, doc->characterCount() - 1)).blockNumber();
+
+    const int count = doc->blockCount();
+    if (count != m_blockCount) {
+        // Las líneas siguientes cambian de número: caen todas las teselas desde aquí
+        m_blockCount = count;
+        const QList<int> tiles = m_tiles.keys();
+        for (int tile : tiles) {
+            if (tile >= first / TILE_LINES) m_tiles.remove(tile);
+        }
+    } else {
+        for (int tile = first / TILE_LINES; tile <= last / TILE_LINES; ++tile) m_tiles.remove(tile);
+    }
+    update();
+}
+
+void Minimap::invalidateTile(int tile) {
+    m_tiles.remove(tile);
+    update();
+}
+
+// ---------- Geometría ----------
+// Si el documento no cabe, el minimapa se desplaza en proporción al editor:
+// el deslizador recorre el alto del widget mientras la vista recorre el documento
+
+int Minimap::scrollOffset() const {
+    const int totalHeight = m_blockCount * LINE_HEIGHT;
+    if (totalHeight <= height()) return 0;
+    const int maxFirst = qMax(1, m_blockCount - m_editor->visibleLineCount());
+    const double progress = qMin(1.0, double(m_editor->firstVisibleLine()) / maxFirst);
+    return int(std::lround(progress * (totalHeight - height())));
+}
+
+// Píxeles que se mueve el deslizador por cada línea que avanza la vista
+double Minimap::sliderRatio() const {
+    const int totalHeight = m_blockCount * LINE_HEIGHT;
+    if (totalHeight <= height()) return LINE_HEIGHT;
+    const int maxFirst = qMax(1, m_blockCount - m_editor->visibleLineCount());
+    return qMax(0.01, LINE_HEIGHT - double(totalHeight - height()) / maxFirst);
+}
+
+int Minimap::sliderTop() const {
+    return m_editor->firstVisibleLine() * LINE_HEIGHT - scrollOffset();
+}
+
+// ---------- Pintado ----------
+
+void Minimap::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(18, 28, 48));
+    if (!m_document) return;
+
+    const int tileHeight = TILE_LINES * LINE_HEIGHT;
+    const int offset = scrollOffset();
+    const int firstTile = offset / tileHeight;
+    const int lastTile = (offset + height()) / tileHeight;
+    for (int tile = firstTile; tile <= lastTile && tile * TILE_LINES < m_blockCount; ++tile) {
+        QImage image;
+        if (const QImage *cached = m_tiles.object(tile)) {
+            image = *cached;
+        } else {
+            image = renderTile(tile);
+            m_tiles.insert(tile, new QImage(image), int(image.sizeInBytes() / 1024) + 1);
+        }
+        painter.drawImage(0, tile * tileHeight - offset, image);
+    }
+
+    const int sliderHeight = qMax(LINE_HEIGHT, m_editor->visibleLineCount() * LINE_HEIGHT);
+    painter.fillRect(QRect(0, sliderTop(), width(), sliderHeight), QColor(220, 230, 245, 40));
+}
+
+// Una fila por línea y un píxel por columna con el color de primer plano que
+// dejó el highlighter (léxico + semántico) en el layout del bloque
+QImage Minimap::renderTile(int tile) const {
+    QImage image(WIDTH, TILE_LINES * LINE_HEIGHT, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    const QRgb defaultColor = qPremultiply(qRgba(171, 178, 191, 200));
+    QVarLengthArray<QRgb, 256> colors;
+    QTextBlock block = m_document->textDocument()->findBlockByNumber(tile * TILE_LINES);
+    for (int row = 0; row < TILE_LINES && block.isValid(); ++row, block = block.next()) {
+        // Solo caben WIDTH columnas: de una línea larga no se mira el resto
+        const QString text = block.text().left(WIDTH);
+        colors.resize(text.size());
+        std::fill(colors.begin(), colors.end(), defaultColor);
+        if (const QTextLayout *layout = block.layout()) {
+            for (const QTextLayout::FormatRange &range : layout->formats()) {
+                if (!range.format.hasProperty(QTextFormat::ForegroundBrush)) continue;
+                const QColor c = range.format.foreground().color();
+                const QRgb rgb = qPremultiply(qRgba(c.red(), c.green(), c.blue(), 200));
+                const int end = qMin(int(text.size()), range.start + range.length);
+                for (int i = qMax(0, range.start); i < end; ++i) colors[i] = rgb;
+            }
+        }
+
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(row * LINE_HEIGHT));
+        int column = 0;
+        for (int i = 0; i < text.size() && column < WIDTH; ++i) {
+            const QChar c = text[i];
+            if (c == QLatin1Char('\t')) {
+                column += 4 - column % 4;
+                continue;
+            }
+            if (!c.isSpace()) line[column] = colors[i];
+            ++column;
+        }
+    }
+    return image;
+}
+
+// ---------- Ratón ----------
+
+void Minimap::mousePressEvent(QMouseEvent *event) {
+    if (event->button() != Qt::LeftButton || !m_document) return;
+    const int y = int(event->position().y());
+    const int top = sliderTop();
+    const int sliderHeight = m_editor->visibleLineCount() * LINE_HEIGHT;
+    if (y < top || y >= top + sliderHeight) {
+        // Fuera del deslizador: centra la línea pulsada y sigue como arrastre
+        const int line = (y + scrollOffset()) / LINE_HEIGHT;
+        m_editor->scrollToLine(line - m_editor->visibleLineCount() / 2);
+    }
+    m_dragOffset = y - sliderTop();
+}
+
+void Minimap::mouseMoveEvent(QMouseEvent *event) {
+    if (m_dragOffset < 0 || !(event->buttons() & Qt::LeftButton)) return;
+    const double top = event->position().y() - m_dragOffset;
+    m_editor->scrollToLine(int(std::lround(top / sliderRatio())));
+}
+
+void Minimap::mouseReleaseEvent(QMouseEvent *) {
+    m_dragOffset = -1;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QMetaObject>
+#include <QWidget>
+
+class Document;
+class Editor;
+
+// Vista en miniatura del documento a la derecha del Editor. Cada línea es una
+// fila de 1 px con un píxel por columna, coloreado con los formatos que dejó
+// el highlighter. Se pinta por teselas de TILE_LINES líneas que se cachean y
+// solo se invalidan cuando cambian o se rehighlightean sus bloques, así que
+// arrastrar la vista solo copia las pocas teselas que caben en pantalla.
+class Minimap : public QWidget {
+    Q_OBJECT
+public:
+    explicit Minimap(Editor *editor);
+
+    void setDocument(Document *document);
+
+    static constexpr int WIDTH = 100;
+    static constexpr int LINE_HEIGHT = 2;
+    static constexpr int TILE_LINES = 128;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+    void invalidateTile(int tile);
+    QImage renderTile(int tile) const;
+    int scrollOffset() const;
+    double sliderRatio() const;
+    int sliderTop() const;
+
+    Editor *m_editor;
+    Document *m_document = nullptr;
+    QList<QMetaObject::Connection> m_connections;
+    QCache<int, QImage> m_tiles;      // coste en KB
+    int m_blockCount = 0;
+    int m_dragOffset = -1;            // distancia del ratón al borde del deslizador
+};
@@ -0,0 +1,233 @@
+#include "NinjaLog.h"
+
+#include <QFile>
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+
+#include <algorithm>
+
+namespace {
+
+// Solo la última ejecución de ninja: dentro de una se anota cada arista al
+// terminar, así que los fines crecen; si uno retrocede empieza otra
+QVector<NinjaEdge> readLastBuild(const QString &logPath) {
+    QVector<NinjaEdge> edges;
+    QFile f(logPath);
+    if (!f.open(QIODevice::ReadOnly)) return edges;
+
+    QHash<QByteArray, int> byCommand;   // hash de la orden + tiempos → arista
+    qint64 lastEnd = -1;
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+        const QList<QByteArray> fields = line.split('\t');
+        if (fields.size() < 5) continue;
+        NinjaEdge edge;
+        edge.startMs = fields[0].toLongLong();
+        edge.endMs = fields[1].toLongLong();
+        edge.output = QString::fromUtf8(fields[3]);
+        edge.outputs << edge.output;
+        if (edge.endMs < lastEnd) {
+            edges.clear();
+            byCommand.clear();
+        }
+        lastEnd = edge.endMs;
+
+        const QByteArray key = fields[4] + ':' + fields[0] + ':' + fields[1];
+        const auto it = byCommand.constFind(key);
+        if (it != byCommand.cend()) {
+            edges[*it].outputs << QString::fromUtf8(fields[3]);
+            continue;
+        }
+        byCommand.insert(key, int(edges.size()));
+        edges.append(edge);
+    }
+    return edges;
+}
+
+// Aristas recompiladas de las que depende 'node', atravesando lo que no se
+// recompiló (fuentes, phony)
+QVector<int> producers(const QString &node, const QHash<QString, int> &edgeOf,
+                       const QHash<QString, QStringList> &inputs, QHash<QString, QVector<int>> &memo) {
+    const auto known = memo.constFind(node);
+    if (known != memo.cend()) return *known;
+    QVector<int> result;
+    const auto edge = edgeOf.constFind(node);
+    if (edge != edgeOf.cend()) {
+        result.append(*edge);
+    } else {
+        for (const QString &input : inputs.value(node)) {
+            for (int p : producers(input, edgeOf, inputs, memo)) {
+                if (!result.contains(p)) result.append(p);
+            }
+        }
+    }
+    memo.insert(node, result);
+    return result;
+}
+
+// Camino más largo del DAG de aristas recompiladas, pesando cada una por su duración
+void computeCriticalPath(NinjaBuildAnalysis &a, const QHash<QString, QStringList> &inputs) {
+    if (inputs.isEmpty()) return;
+    const int n = int(a.edges.size());
+    QHash<QString, int> edgeOf;
+    for (int i = 0; i < n; ++i) {
+        for (const QString &output : std::as_const(a.edges[i].outputs)) edgeOf.insert(output, i);
+    }
+
+    QHash<QString, QVector<int>> memo;
+    QVector<QVector<int>> deps(n);
+    for (int i = 0; i < n; ++i) {
+        for (const QString &output : std::as_const(a.edges[i].outputs)) {
+            for (const QString &input : inputs.value(output)) {
+                for (int p : producers(input, edgeOf, inputs, memo)) {
+                    if (p != i && !deps[i].contains(p)) deps[i].append(p);
+                }
+            }
+        }
+    }
+
+    // Las dependencias acaban antes de empezar: por orden de fin ya están calculadas
+    QVector<int> order(n);
+    for (int i = 0; i < n; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&a](int x, int y) {
+        return a.edges[x].endMs != a.edges[y].endMs ? a.edges[x].endMs < a.edges[y].endMs
+                                                    : a.edges[x].startMs < a.edges[y].startMs;
+    });
+    QVector<qint64> length(n, -1);
+    QVector<int> previous(n, -1);
+    for (int i : std::as_const(order)) {
+        qint64 best = 0;
+        for (int d : std::as_const(deps[i])) {
+            if (length[d] > best) {
+                best = length[d];
+                previous[i] = d;
+            }
+        }
+        length[i] = best + a.edges[i].duration();
+    }
+
+    int current = int(std::max_element(length.cbegin(), length.cend()) - length.cbegin());
+    a.criticalMs = length[current];
+    QVector<int> path;
+    for (; current >= 0; current = previous[current]) path.append(current);
+    std::reverse(path.begin(), path.end());
+    a.criticalPath = path;
+    for (int i : std::as_const(path)) a.edges[i].critical = true;
+}
+
+void computeParallelism(NinjaBuildAnalysis &a) {
+    struct Event {
+        qint64 time;
+        int delta;
+        int edge;
+    };
+    QVector<Event> events;
+    events.reserve(a.edges.size() * 2);
+    for (int i = 0; i < a.edges.size(); ++i) {
+        events.append({a.edges[i].startMs, +1, i});
+        events.append({a.edges[i].endMs, -1, i});
+    }
+    // A igual instante los fines antes que los inicios
+    std::sort(events.begin(), events.end(), [](const Event &x, const Event &y) {
+        return x.time != y.time ? x.time < y.time : x.delta < y.delta;
+    });
+
+    QSet<int> running;
+    qint64 last = events.isEmpty() ? 0 : events.first().time;
+    for (const Event &e : std::as_const(events)) {
+        if (running.size() == 1 && e.time > last) a.edges[*running.cbegin()].serialMs += e.time - last;
+        if (e.delta > 0) running.insert(e.edge);
+        else running.remove(e.edge);
+        if (!a.parallelism.isEmpty() && a.parallelism.last().first == e.time)
+            a.parallelism.last().second = int(running.size());
+        else
+            a.parallelism.append({e.time, int(running.size())});
+        last = e.time;
+    }
+
+    for (int i = 0; i < a.edges.size(); ++i) {
+        if (a.edges[i].serialMs > 0) a.serializing.append(i);
+    }
+    std::sort(a.serializing.begin(), a.serializing.end(), [&a](int x, int y) {
+        return a.edges[x].serialMs > a.edges[y].serialMs;
+    });
+}
+
+// Cada arista a la primera fila libre
+void assignLanes(NinjaBuildAnalysis &a) {
+    QVector<qint64> laneEnd;
+    for (NinjaEdge &edge : a.edges) {
+        int lane = 0;
+        while (lane < laneEnd.size() && laneEnd[lane] > edge.startMs) ++lane;
+        if (lane == laneEnd.size()) laneEnd.append(0);
+        laneEnd[lane] = edge.endMs;
+        edge.lane = lane;
+    }
+    a.lanes = int(laneEnd.size());
+}
+
+} // namespace
+
+namespace NinjaLog {
+
+QHash<QString, QStringList> parseGraph(const QByteArray &dot) {
+    //   "0x1" [label="foo.o"]          nodo (shape=ellipse: arista con varias entradas o salidas)
+    //   "0x1" -> "0x2" [label=" CXX"]   entrada -> salida, o a través de la elipse
+    static const QRegularExpression nodeRe(QStringLiteral("^\"([^\"]+)\" \\[label=\"((?:[^\"\\\\]|\\\\.)*)\"(, shape=ellipse)?"));
+    static const QRegularExpression arrowRe(QStringLiteral("^\"([^\"]+)\" -> \"([^\"]+)\""));
+    QHash<QString, QString> labels;
+    QSet<QString> rules;
+    QVector<QPair<QString, QString>> arrows;
+    for (const QByteArray &raw : dot.split('\n')) {
+        const QString line = QString::fromUtf8(raw.trimmed());
+        QRegularExpressionMatch m = arrowRe.match(line);
+        if (m.hasMatch()) {
+            arrows.append({m.captured(1), m.captured(2)});
+            continue;
+        }
+        m = nodeRe.match(line);
+        if (!m.hasMatch()) continue;
+        labels.insert(m.captured(1), m.captured(2).replace(QLatin1String("\\\""), QLatin1String("\"")));
+        if (m.capturedLength(3)) rules.insert(m.captured(1));
+    }
+
+    QHash<QString, QStringList> ruleInputs;
+    QHash<QString, QStringList> ruleOutputs;
+    QHash<QString, QStringList> inputs;
+    for (const auto &[from, to] : std::as_const(arrows)) {
+        if (rules.contains(to)) ruleInputs[to] << labels.value(from);
+        else if (rules.contains(from)) ruleOutputs[from] << labels.value(to);
+        else inputs[labels.value(to)] << labels.value(from);
+    }
+    for (auto it = ruleOutputs.cbegin(); it != ruleOutputs.cend(); ++it) {
+        for (const QString &output : it.value()) inputs[output] << ruleInputs.value(it.key());
+    }
+    return inputs;
+}
+
+NinjaBuildAnalysis analyze(const QString &logPath, const QHash<QString, QStringList> &inputs) {
+    NinjaBuildAnalysis a;
+    a.edges = readLastBuild(logPath);
+    if (a.edges.isEmpty()) return a;
+    std::sort(a.edges.begin(), a.edges.end(), [](const NinjaEdge &x, const NinjaEdge &y) {
+        return x.startMs < y.startMs;
+    });
+
+    qint64 first = a.edges.first().startMs;
+    qint64 last = 0;
+    for (const NinjaEdge &edge : std::as_const(a.edges)) {
+        first = qMin(first, edge.startMs);
+        last = qMax(last, edge.endMs);
+        a.totalMs += edge.duration();
+    }
+    a.wallMs = last - first;
+
+    computeCriticalPath(a, inputs);
+    computeParallelism(a);
+    assignLanes(a);
+    return a;
+}
+
+} // namespace NinjaLog
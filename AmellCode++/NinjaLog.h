@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Análisis de la última compilación registrada en build/.ninja_log.
+//
+// El registro solo guarda inicio y fin de cada arista; las dependencias
+// salen de "ninja -t graph". El camino crítico es la cadena de aristas
+// recompiladas, dependientes entre sí, con más duración acumulada: por
+// muchos núcleos que haya, esa compilación no baja de ahí. Sin grafo no se
+// calcula (encadenar por tiempos en una compilación -jN saturada une
+// aristas que no dependen entre sí).
+//
+// El paralelismo se calcula barriendo inicios y fines, y el tiempo en que
+// solo corre una arista se atribuye a ella: son las que serializan la
+// compilación.
+struct NinjaEdge {
+    QString output;                   // el primero de 'outputs'
+    QStringList outputs;              // una arista puede producir varios ficheros
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+    qint64 serialMs = 0;              // tiempo corriendo sola
+    int lane = 0;                     // fila de la cronología
+    bool critical = false;
+
+    qint64 duration() const { return endMs - startMs; }
+};
+
+struct NinjaBuildAnalysis {
+    QVector<NinjaEdge> edges;         // por inicio
+    QVector<int> criticalPath;        // índices en orden de ejecución; vacío sin grafo
+    QVector<int> serializing;         // índices con serialMs > 0, de más a menos
+    QVector<QPair<qint64, int>> parallelism;   // (instante, aristas corriendo) desde ese instante
+    qint64 wallMs = 0;
+    qint64 totalMs = 0;               // suma de duraciones
+    qint64 criticalMs = 0;
+    int lanes = 0;
+    bool upToDate = false;            // ninja no recompiló nada
+
+    bool isEmpty() const { return edges.isEmpty(); }
+    double averageParallelism() const { return wallMs > 0 ? double(totalMs) / wallMs : 0.0; }
+};
+
+namespace NinjaLog {
+
+// Entradas de cada fichero según la salida de "ninja -t graph" (formato dot)
+QHash<QString, QStringList> parseGraph(const QByteArray &dot);
+NinjaBuildAnalysis analyze(const QString &logPath, const QHash<QString, QStringList> &inputs);
+
+} // namespace NinjaLog
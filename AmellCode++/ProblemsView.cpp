@@ -0,0 +1,53 @@
+#include "ProblemsView.h"
+
+#include <QFileInfo>
+#include <QHeaderView>
+
+ProblemsView::ProblemsView(QWidget *parent)
+    : QTreeWidget(parent) {
+    setHeaderLabels({tr("Tipo"), tr("Fichero"), tr("Línea"), tr("Mensaje")});
+    setRootIsDecorated(false);
+    setUniformRowHeights(true);
+    setSortingEnabled(false);
+    header()->setStretchLastSection(true);
+    connect(this, &QTreeWidget::itemClicked, this, [this](QTreeWidgetItem *item) {
+        const int index = item->data(0, Qt::UserRole).toInt();
+        if (index >= 0 && index < m_diagnostics.size()) emit problemActivated(m_diagnostics[index]);
+    });
+}
+
+QVector<Diagnostic> ProblemsView::addDiagnostics(const QVector<Diagnostic> &diagnostics) {
+    QVector<Diagnostic> added;
+    QList<QTreeWidgetItem *> items;
+    for (const Diagnostic &d : diagnostics) {
+        const QString key = QStringLiteral("%1:%2:%3:%4").arg(d.file).arg(d.line).arg(d.column).arg(d.message);
+        if (m_seen.contains(key)) continue;
+        m_seen.insert(key);
+
+        auto item = new QTreeWidgetItem;
+        const bool error = d.severity == Diagnostic::Error;
+        const bool warning = d.severity == Diagnostic::Warning;
+        item->setText(0, error ? tr("error") : warning ? tr("advertencia") : tr("nota"));
+        item->setForeground(0, error ? QColor("#E06C75") : warning ? QColor("#E5C07B") : QColor("#61AFEF"));
+        item->setText(1, QFileInfo(d.file).fileName());
+        item->setToolTip(1, d.file);
+        item->setText(2, QString::number(d.line + 1));
+        item->setText(3, d.message);
+        item->setData(0, Qt::UserRole, int(m_diagnostics.size()));
+        items.append(item);
+        m_diagnostics.append(d);
+        added.append(d);
+        if (error) ++m_errors;
+        else if (warning) ++m_warnings;
+    }
+    if (!items.isEmpty()) addTopLevelItems(items);
+    return added;
+}
+
+void ProblemsView::clearDiagnostics() {
+    clear();
+    m_diagnostics.clear();
+    m_seen.clear();
+    m_errors = 0;
+    m_warnings = 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QSet>
+#include <QTreeWidget>
+#include <QVector>
+
+#include "Diagnostic.h"
+
+// Lista de diagnósticos de la última compilación. Los lotes del parser se
+// añaden de una vez y sin duplicados: en una compilación paralela la misma
+// advertencia de una cabecera llega desde cada unidad que la incluye.
+class ProblemsView : public QTreeWidget {
+    Q_OBJECT
+public:
+    explicit ProblemsView(QWidget *parent = nullptr);
+
+    // Devuelve los que eran nuevos
+    QVector<Diagnostic> addDiagnostics(const QVector<Diagnostic> &diagnostics);
+    void clearDiagnostics();
+    int errorCount() const { return m_errors; }
+    int warningCount() const { return m_warnings; }
+
+signals:
+    void problemActivated(const Diagnostic &diagnostic);
+
+private:
+    QVector<Diagnostic> m_diagnostics;
+    QSet<QString> m_seen;
+    int m_errors = 0;
+    int m_warnings = 0;
+};
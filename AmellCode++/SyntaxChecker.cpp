@@ -0,0 +1,108 @@
+#include "SyntaxChecker.h"
+#include "BuildScheduler.h"
+#include "CompileCommands.h"
+#include "CompilerOutputParser.h"
+#include "Document.h"
+
+#include <QFileInfo>
+#include <QTextDocument>
+#include <QTimer>
+
+namespace {
+
+// La orden de compilación sin salida ni ficheros de dependencias y sin el
+// fichero de entrada, que pasa a ser stdin
+QStringList syntaxOnlyArguments(const CompileCommands::Entry &entry, const QString &filePath) {
+    static const QStringList withValue = {"-o", "-MF", "-MT", "-MQ"};
+    static const QStringList dropped = {"-c", "-M", "-MM", "-MD", "-MMD", "-MP"};
+    QStringList args;
+    for (int i = 1; i < entry.arguments.size(); ++i) {
+        const QString &arg = entry.arguments[i];
+        if (withValue.contains(arg)) {
+            ++i;
+            continue;
+        }
+        if (dropped.contains(arg) || arg.startsWith(QLatin1String("-o"))) continue;
+        if (!arg.startsWith(QLatin1Char('-'))
+                && QFileInfo(entry.directory + "/" + arg).absoluteFilePath() == QFileInfo(entry.file).absoluteFilePath())
+            continue;
+        args << arg;
+    }
+    const bool isC = QFileInfo(filePath).suffix() == QLatin1String("c");
+    args << "-fsyntax-only"
+         << "-iquote" << QFileInfo(filePath).absolutePath()
+         << "-x" << (isC ? "c" : "c++") << "-";
+    return args;
+}
+
+} // namespace
+
+SyntaxChecker::SyntaxChecker(BuildScheduler *scheduler, CompileCommands *commands, QObject *parent)
+    : QObject(parent),
+      m_scheduler(scheduler),
+      m_commands(commands),
+      m_timer(new QTimer(this)) {
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &SyntaxChecker::check);
+    // Con la tabla recién leída se comprueba lo que antes no tenía orden
+    connect(m_commands, &CompileCommands::loaded, this, [this]() {
+        if (m_document) m_timer->start(SAVE_DELAY);
+    });
+
+    connect(m_scheduler, &BuildScheduler::jobStarted, this, [this](int id) {
+        if (id == m_job) m_output.clear();
+    });
+    connect(m_scheduler, &BuildScheduler::jobOutput, this, [this](int id, const QByteArray &bytes) {
+        if (id == m_job) m_output += bytes;
+    });
+    connect(m_scheduler, &BuildScheduler::jobFinished, this, [this](int id, BuildScheduler::State state) {
+        if (id != m_job || state == BuildScheduler::Cancelled) return;
+        m_job = 0;
+        QVector<Diagnostic> diagnostics;
+        for (const QByteArray &line : m_output.split('\n')) {
+            for (Diagnostic d : CompilerOutputParser::parseLine(QString::fromUtf8(line).trimmed(), m_checkedDir)) {
+                if (QFileInfo(d.file).fileName() == QLatin1String("<stdin>")) d.file = m_checkedPath;
+                d.source = QStringLiteral("sintaxis");
+                diagnostics.append(d);
+            }
+        }
+        m_output.clear();
+        emit diagnosticsReady(m_checkedPath, diagnostics);
+    });
+}
+
+void SyntaxChecker::setDocument(Document *document) {
+    if (document == m_document) return;
+    for (const QMetaObject::Connection &c : std::as_const(m_connections)) disconnect(c);
+    m_connections.clear();
+    m_timer->stop();
+
+    m_document = document;
+    if (!document) return;
+    m_connections << connect(document->textDocument(), &QTextDocument::contentsChanged, this, [this]() {
+        m_timer->start(IDLE_DELAY);
+    });
+    m_connections << connect(document, &Document::saved, this, [this]() {
+        m_timer->start(SAVE_DELAY);
+    });
+}
+
+void SyntaxChecker::check() {
+    if (!m_document || m_document->filePath().isEmpty() || m_document->isTailing()) return;
+    const QString filePath = m_document->filePath();
+    const CompileCommands::Entry entry = m_commands->lookup(filePath);
+    if (!entry.isValid()) return;
+
+    if (m_job) m_scheduler->cancel(m_job);
+
+    BuildScheduler::Job job;
+    job.key = QStringLiteral("syntax");
+    job.title = tr("Comprobación de sintaxis");
+    job.program = entry.arguments.first();
+    job.arguments = syntaxOnlyArguments(entry, filePath);
+    job.workingDirectory = entry.directory;
+    job.input = m_document->textDocument()->toPlainText().toUtf8();
+    m_checkedPath = filePath;
+    m_checkedDir = entry.directory;
+    m_job = m_scheduler->submit(job);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+#include "Diagnostic.h"
+
+class BuildScheduler;
+class CompileCommands;
+class Document;
+class QTimer;
+
+// Comprobación de sintaxis en segundo plano del documento activo: al
+// guardar o tras una pausa al escribir se compila con -fsyntax-only y las
+// opciones de compile_commands.json. Se compila el texto del editor (por
+// stdin), no el del disco, así que los errores aparecen sin guardar y sin
+// pasar por "cmake --build". Cada comprobación cancela la anterior.
+class SyntaxChecker : public QObject {
+    Q_OBJECT
+public:
+    SyntaxChecker(BuildScheduler *scheduler, CompileCommands *commands, QObject *parent = nullptr);
+
+    void setDocument(Document *document);
+
+    static constexpr int IDLE_DELAY = 500;
+    static constexpr int SAVE_DELAY = 50;
+
+signals:
+    void diagnosticsReady(const QString &filePath, const QVector<Diagnostic> &diagnostics);
+
+private:
+    void check();
+
+    BuildScheduler *m_scheduler;
+    CompileCommands *m_commands;
+    QPointer<Document> m_document;
+    QList<QMetaObject::Connection> m_connections;
+    QTimer *m_timer;
+
+    int m_job = 0;
+    QString m_checkedPath;            // fichero de la comprobación en curso
+    QString m_checkedDir;
+    QByteArray m_output;
+};
@@ -0,0 +1,57 @@
+#include "TargetsView.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHeaderView>
+
+TargetsView::TargetsView(QWidget *parent)
+    : QTreeWidget(parent) {
+    setHeaderLabels({tr("Objetivo"), tr("Tipo")});
+    setUniformRowHeights(true);
+    header()->setStretchLastSection(false);
+    header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    connect(this, &QTreeWidget::itemDoubleClicked, this, [this](QTreeWidgetItem *item) {
+        const QString path = item->data(0, Qt::UserRole).toString();
+        if (item->parent() && !path.isEmpty()) emit fileActivated(path);
+    });
+}
+
+void TargetsView::setTargets(const QVector<CMakeTarget> &targets) {
+    const QString selected = currentTarget();
+    clear();
+
+    QList<QTreeWidgetItem *> items;
+    for (const CMakeTarget &target : targets) {
+        auto item = new QTreeWidgetItem;
+        item->setText(0, target.name);
+        item->setText(1, target.type.toLower().replace(QLatin1Char('_'), QLatin1Char(' ')));
+        item->setToolTip(0, target.artifacts.join(QLatin1Char('\n')));
+        item->setData(0, Qt::UserRole, target.name);
+        if (target.isExecutable()) {
+            QFont font = item->font(0);
+            font.setBold(true);
+            item->setFont(0, font);
+        }
+        for (const QString &source : target.sources) {
+            auto child = new QTreeWidgetItem(item);
+            child->setText(0, QFileInfo(source).fileName());
+            child->setToolTip(0, QDir::toNativeSeparators(source));
+            child->setData(0, Qt::UserRole, source);
+        }
+        items.append(item);
+    }
+    addTopLevelItems(items);
+
+    for (QTreeWidgetItem *item : std::as_const(items)) {
+        if (item->text(0) == selected) setCurrentItem(item);
+    }
+}
+
+// Seleccionar una fuente cuenta como seleccionar su objetivo
+QString TargetsView::currentTarget() const {
+    QTreeWidgetItem *item = currentItem();
+    if (!item) return QString();
+    while (item->parent()) item = item->parent();
+    return item->text(0);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QTreeWidget>
+#include <QVector>
+
+#include "CMakeProject.h"
+
+// Objetivos del proyecto CMake con sus fuentes. El seleccionado es el que
+// compilan y ejecutan Ctrl+B y Ctrl+R; doble clic en una fuente la abre.
+class TargetsView : public QTreeWidget {
+    Q_OBJECT
+public:
+    explicit TargetsView(QWidget *parent = nullptr);
+
+    // Conserva la selección si el objetivo sigue existiendo
+    void setTargets(const QVector<CMakeTarget> &targets);
+    // Vacío si no hay ninguno seleccionado
+    QString currentTarget() const;
+
+signals:
+    void fileActivated(const QString &filePath);
+};
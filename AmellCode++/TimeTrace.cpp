@@ -0,0 +1,117 @@
+#include "TimeTrace.h"
+
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QThread>
+#include <QThreadPool>
+
+namespace {
+
+using ItemMap = QHash<QString, TimeTraceItem>;   // tipo + nombre → acumulado
+
+void accumulate(ItemMap &map, TimeTraceItem::Kind kind, const QString &name, qint64 us,
+                const QString &file = QString(), int line = -1) {
+    TimeTraceItem &item = map[QString::number(kind) + QLatin1Char('|') + name];
+    if (item.count == 0) {
+        item.kind = kind;
+        item.name = name;
+        item.file = file;
+        item.line = line;
+    }
+    item.totalUs += us;
+    ++item.count;
+}
+
+void aggregateFile(const QString &path, ItemMap &map) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return;
+    const QJsonArray events = QJsonDocument::fromJson(f.readAll()).object().value("traceEvents").toArray();
+    // foo.cpp.json junto a foo.cpp.o
+    const QString unit = QFileInfo(path).completeBaseName();
+    for (const QJsonValue &value : events) {
+        const QJsonObject event = value.toObject();
+        if (event.value("ph").toString() != QLatin1String("X")) continue;
+        const QString name = event.value("name").toString();
+        const qint64 dur = event.value("dur").toInteger();
+        const QJsonObject args = event.value("args").toObject();
+        const QString detail = args.value("detail").toString();
+
+        if (name == QLatin1String("Total ExecuteCompiler")) {
+            accumulate(map, TimeTraceItem::Unit, unit, dur);
+        } else if (name == QLatin1String("Source")) {
+            accumulate(map, TimeTraceItem::Header, detail, dur, detail, 0);
+        } else if (name == QLatin1String("InstantiateClass") || name == QLatin1String("InstantiateFunction")) {
+            // Clang reciente añade la ubicación de la plantilla
+            accumulate(map, TimeTraceItem::Template, detail, dur,
+                       args.value("file").toString(), args.value("line").toInt(0) - 1);
+        } else if (name == QLatin1String("OptFunction")) {
+            accumulate(map, TimeTraceItem::Function, detail, dur);
+        }
+    }
+}
+
+} // namespace
+
+namespace TimeTrace {
+
+QStringList findTraces(const QString &buildDir) {
+    QStringList traces;
+    QDirIterator it(buildDir, {"*.json"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (!path.contains(QLatin1String("/CMakeFiles/")) || !path.contains(QLatin1String(".dir/"))) continue;
+        QFile f(path);
+        if (f.open(QIODevice::ReadOnly) && f.peek(64).contains("traceEvents")) traces << path;
+    }
+    return traces;
+}
+
+// Un trozo de la lista por hilo; cada uno acumula en su tabla y al final se juntan
+QVector<TimeTraceItem> aggregateClang(const QStringList &traceFiles) {
+    const int chunks = qMax(1, qMin(QThread::idealThreadCount(), int(traceFiles.size())));
+    QVector<ItemMap> partial(chunks);
+    QThreadPool pool;
+    for (int c = 0; c < chunks; ++c) {
+        pool.start([c, chunks, &traceFiles, &partial]() {
+            for (int i = c; i < traceFiles.size(); i += chunks) aggregateFile(traceFiles[i], partial[c]);
+        });
+    }
+    pool.waitForDone();
+
+    ItemMap merged = partial.first();
+    for (int c = 1; c < chunks; ++c) {
+        for (auto it = partial[c].cbegin(); it != partial[c].cend(); ++it) {
+            TimeTraceItem &item = merged[it.key()];
+            if (item.count == 0) {
+                item = *it;
+            } else {
+                item.totalUs += it->totalUs;
+                item.count += it->count;
+            }
+        }
+    }
+    return merged.values();
+}
+
+QVector<TimeTraceItem> aggregateGccReport(const QByteArray &buildLog) {
+    //  phase parsing        :   0.52 ( 60%)   0.10 ( 45%)   0.63 ( 58%)  61M ( 55%)
+    static const QRegularExpression re(
+        QStringLiteral("^\\s*(\\S.*?)\\s*:\\s*[\\d.]+\\s*\\(\\s*\\d+%\\)\\s+[\\d.]+\\s*\\(\\s*\\d+%\\)\\s+([\\d.]+)\\s*\\("));
+    ItemMap map;
+    for (const QByteArray &raw : buildLog.split('\n')) {
+        if (!raw.contains('%')) continue;
+        const QRegularExpressionMatch m = re.match(QString::fromUtf8(raw));
+        if (!m.hasMatch()) continue;
+        const qint64 us = qint64(m.capturedView(2).toDouble() * 1e6);
+        accumulate(map, TimeTraceItem::Phase, m.captured(1), us);
+    }
+    return map.values();
+}
+
+} // namespace TimeTrace
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Agregado de los perfiles de tiempo de compilación de todo el proyecto.
+//
+// Clang deja con -ftime-trace un JSON por unidad junto a su objeto; se leen
+// en paralelo y se suman por cabecera (evento "Source"), instanciación de
+// plantilla y función optimizada. GCC con -ftime-report solo escribe en la
+// salida las fases de cada unidad, así que de él se agregan las fases.
+struct TimeTraceItem {
+    enum Kind { Unit, Header, Template, Function, Phase };
+
+    Kind kind = Unit;
+    QString name;
+    QString file;                     // vacío si no hay ubicación
+    int line = -1;
+    qint64 totalUs = 0;
+    int count = 0;
+};
+
+namespace TimeTrace {
+
+// Las trazas de Clang bajo los CMakeFiles/<objetivo>.dir del directorio de compilación
+QStringList findTraces(const QString &buildDir);
+QVector<TimeTraceItem> aggregateClang(const QStringList &traceFiles);
+// Tablas "Time variable" de -ftime-report en la salida de la compilación
+QVector<TimeTraceItem> aggregateGccReport(const QByteArray &buildLog);
+
+} // namespace TimeTrace
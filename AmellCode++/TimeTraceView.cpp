@@ -0,0 +1,50 @@
+#include "TimeTraceView.h"
+
+#include <QFileInfo>
+#include <QHeaderView>
+
+#include <algorithm>
+
+TimeTraceView::TimeTraceView(QWidget *parent)
+    : QTreeWidget(parent) {
+    setHeaderLabels({tr("Tipo"), tr("Nombre"), tr("Total (ms)"), tr("Veces"), tr("Media (ms)")});
+    setRootIsDecorated(false);
+    setUniformRowHeights(true);
+    setSortingEnabled(true);
+    header()->setSectionResizeMode(1, QHeaderView::Stretch);
+    header()->setStretchLastSection(false);
+    connect(this, &QTreeWidget::itemClicked, this, [this](QTreeWidgetItem *item) {
+        const QString file = item->data(1, Qt::UserRole).toString();
+        if (!file.isEmpty()) emit locationActivated(file, item->data(1, Qt::UserRole + 1).toInt());
+    });
+}
+
+void TimeTraceView::setItems(const QVector<TimeTraceItem> &items) {
+    static const QStringList kinds = {tr("unidad"), tr("cabecera"), tr("plantilla"), tr("función"), tr("fase")};
+    setSortingEnabled(false);
+    clear();
+
+    QVector<TimeTraceItem> sorted = items;
+    std::sort(sorted.begin(), sorted.end(), [](const TimeTraceItem &a, const TimeTraceItem &b) {
+        return a.totalUs > b.totalUs;
+    });
+    QHash<int, int> perKind;
+    QList<QTreeWidgetItem *> rows;
+    for (const TimeTraceItem &t : std::as_const(sorted)) {
+        if (++perKind[t.kind] > MAX_ROWS) continue;
+        auto row = new QTreeWidgetItem;
+        row->setText(0, kinds.value(t.kind));
+        row->setText(1, t.kind == TimeTraceItem::Header ? QFileInfo(t.name).fileName() : t.name);
+        row->setToolTip(1, t.file.isEmpty() ? t.name : t.file);
+        // Números como datos y no como texto: la columna se ordena por valor
+        row->setData(2, Qt::DisplayRole, qRound64(t.totalUs / 1000.0));
+        row->setData(3, Qt::DisplayRole, t.count);
+        row->setData(4, Qt::DisplayRole, qRound64(t.totalUs / 1000.0 / qMax(1, t.count)));
+        row->setData(1, Qt::UserRole, t.file);
+        row->setData(1, Qt::UserRole + 1, qMax(0, t.line));
+        rows.append(row);
+    }
+    addTopLevelItems(rows);
+    setSortingEnabled(true);
+    sortByColumn(2, Qt::DescendingOrder);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QTreeWidget>
+#include <QVector>
+
+#include "TimeTrace.h"
+
+// Resultado del perfil de compilación: una fila por unidad, cabecera,
+// plantilla, función o fase con su tiempo total, veces y media. Ordenable
+// por cualquier columna; las filas con ubicación se abren al pulsarlas.
+class TimeTraceView : public QTreeWidget {
+    Q_OBJECT
+public:
+    explicit TimeTraceView(QWidget *parent = nullptr);
+
+    // Solo las MAX_ROWS más caras de cada tipo
+    void setItems(const QVector<TimeTraceItem> &items);
+
+    static constexpr int MAX_ROWS = 500;
+
+signals:
+    void locationActivated(const QString &file, int line);
+};
@@ -0,0 +1,287 @@
+#include "UndoHistory.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QTextCursor>
+#include <QTextDocument>
+
+#include <iterator>
+
+namespace {
+
+// Texto plano de [from, to) con saltos de línea normales en lugar de U+2029
+QString textRange(QTextDocument *doc, int from, int to) {
+    QTextCursor c(doc);
+    c.setPosition(from);
+    c.setPosition(to, QTextCursor::KeepAnchor);
+    QString text = c.selectedText();
+    text.replace(QChar::ParagraphSeparator, QLatin1Char('\n'));
+    return text;
+}
+
+bool isWordChar(QChar c) {
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
+} // namespace
+
+UndoHistory::UndoHistory(QTextDocument *document)
+    : QObject(document),
+      m_document(document),
+      m_spillFile(QDir::tempPath() + QStringLiteral("/amellide-undo-XXXXXX")) {
+    m_clock.start();
+    connect(document, &QTextDocument::contentsChange, this, &UndoHistory::onContentsChange);
+}
+
+// Guarda [from, to) tal como está ahora; el próximo cambio que caiga dentro
+// de este rango se puede registrar con su texto borrado
+void UndoHistory::prepare(int from, int to) {
+    const int end = m_document->characterCount() - 1;
+    from = qBound(0, from, end);
+    to = qBound(from, to, end);
+    m_snapshotFrom = from;
+    m_snapshot = textRange(m_document, from, to);
+}
+
+void UndoHistory::clear() {
+    m_undo.clear();
+    m_redo.clear();
+    m_memory = 0;
+    m_segments.clear();
+    if (m_spillFile.isOpen()) m_spillFile.resize(0);
+    m_snapshotFrom = -1;
+    m_snapshot.clear();
+    m_sealed = true;
+}
+
+void UndoHistory::beginGroup() {
+    m_grouping = true;
+    m_groupStarted = false;
+    m_sealed = true;
+}
+
+void UndoHistory::endGroup() {
+    m_grouping = false;
+    m_sealed = true;
+}
+
+bool UndoHistory::canUndo() const {
+    return !m_undo.empty() || !m_segments.isEmpty();
+}
+
+bool UndoHistory::canRedo() const {
+    return !m_redo.empty();
+}
+
+void UndoHistory::setMemoryBudget(qint64 bytes) {
+    m_budget = qMax<qint64>(bytes, 64 * 1024);
+    while (m_memory > m_budget && m_undo.size() > 1) spill();
+}
+
+// ---------- Registro ----------
+
+void UndoHistory::onContentsChange(int position, int charsRemoved, int charsAdded) {
+    if (m_applying || (charsRemoved == 0 && charsAdded == 0)) return;
+
+    const int snapshotEnd = m_snapshotFrom + m_snapshot.size();
+    const int end = m_document->characterCount() - 1;
+    if (m_snapshotFrom < 0 || position < m_snapshotFrom || position + charsRemoved > snapshotEnd
+        || position + charsAdded > end) {
+        // Sin el texto borrado no hay forma de volver atrás: el historial empieza de cero
+        clear();
+        return;
+    }
+
+    const QString removed = m_snapshot.mid(position - m_snapshotFrom, charsRemoved);
+    const QString inserted = textRange(m_document, position, position + charsAdded);
+    if (removed == inserted) return;   // solo cambió el formato
+    m_snapshot.replace(position - m_snapshotFrom, charsRemoved, inserted);
+
+    for (const Delta &d : m_redo) m_memory -= cost(d);
+    m_redo.clear();
+
+    if (!m_grouping && coalesce(removed, inserted, position)) return;
+
+    Delta d;
+    d.position = position;
+    d.removed = removed.toUtf8();
+    d.inserted = inserted.toUtf8();
+    d.removedLength = removed.size();
+    d.insertedLength = inserted.size();
+    d.time = m_clock.elapsed();
+    d.joined = m_grouping && m_groupStarted;
+    m_groupStarted = m_grouping;
+    push(std::move(d));
+}
+
+// Une una pulsación con la anterior si continúa la misma racha: escritura
+// seguida (cortando al empezar palabra), retroceso o suprimir consecutivos
+bool UndoHistory::coalesce(const QString &removed, const QString &inserted, int position) {
+    if (m_sealed || m_undo.empty()) return false;
+    Delta &last = m_undo.back();
+    const qint64 now = m_clock.elapsed();
+    if (now - last.time > COALESCE_MS) return false;
+
+    const qint64 before = cost(last);
+    if (removed.isEmpty() && inserted.size() == 1 && last.removed.isEmpty()
+        && position == last.position + last.insertedLength) {
+        const QChar c = inserted.at(0);
+        const QChar previous = QString::fromUtf8(last.inserted.right(4)).back();
+        if (c == QLatin1Char('\n') || (isWordChar(c) && !isWordChar(previous))) return false;
+        last.inserted += inserted.toUtf8();
+        last.insertedLength += 1;
+    } else if (inserted.isEmpty() && removed.size() == 1 && last.inserted.isEmpty()
+               && position + 1 == last.position) {
+        last.removed.prepend(removed.toUtf8());
+        last.removedLength += 1;
+        last.position = position;
+    } else if (inserted.isEmpty() && removed.size() == 1 && last.inserted.isEmpty()
+               && position == last.position) {
+        last.removed += removed.toUtf8();
+        last.removedLength += 1;
+    } else {
+        return false;
+    }
+    last.time = now;
+    m_memory += cost(last) - before;
+    return true;
+}
+
+void UndoHistory::push(Delta d) {
+    m_memory += cost(d);
+    m_undo.push_back(std::move(d));
+    m_sealed = false;
+    while (m_memory > m_budget && m_undo.size() > 1) spill();
+}
+
+// ---------- Deshacer / rehacer ----------
+
+// Un grupo se recorre entero: hacia atrás hasta su primer delta al deshacer
+// y hacia delante mientras los siguientes estén unidos al rehacer
+int UndoHistory::undo() {
+    int position = -1;
+    bool joined = true;
+    while (joined) {
+        if (m_undo.empty() && !reload()) break;
+        Delta d = std::move(m_undo.back());
+        m_undo.pop_back();
+        joined = d.joined;
+        position = apply(d, true);
+        if (position < 0) return -1;
+        m_redo.push_back(std::move(d));
+    }
+    return position;
+}
+
+int UndoHistory::redo() {
+    if (m_redo.empty()) return -1;
+    int position = -1;
+    do {
+        Delta d = std::move(m_redo.back());
+        m_redo.pop_back();
+        position = apply(d, false);
+        if (position < 0) return -1;
+        m_undo.push_back(std::move(d));
+    } while (!m_redo.empty() && m_redo.back().joined);
+    return position;
+}
+
+// Sustituye el texto que dejó el delta por el que había (o al revés) en un
+// único bloque de edición; devuelve dónde queda el final del texto restaurado
+int UndoHistory::apply(const Delta &d, bool undo) {
+    const int length = undo ? d.insertedLength : d.removedLength;
+    if (d.position + length > m_document->characterCount() - 1) {
+        clear();
+        return -1;
+    }
+    const QString text = QString::fromUtf8(undo ? d.removed : d.inserted);
+
+    m_applying = true;
+    QTextCursor c(m_document);
+    c.beginEditBlock();
+    c.setPosition(d.position);
+    c.setPosition(d.position + length, QTextCursor::KeepAnchor);
+    c.removeSelectedText();
+    if (!text.isEmpty()) c.insertText(text);
+    c.endEditBlock();
+    m_applying = false;
+
+    m_snapshotFrom = -1;
+    m_snapshot.clear();
+    m_sealed = true;
+    return d.position + text.size();
+}
+
+// ---------- Volcado a disco ----------
+
+// Comprime los deltas más antiguos hasta dejar la memoria en la mitad del
+// presupuesto y los añade como un segmento al final del fichero temporal
+void UndoHistory::spill() {
+    if (!m_spillFile.isOpen() && !m_spillFile.open()) {
+        // Sin disco disponible se pierde lo más antiguo
+        m_memory -= cost(m_undo.front());
+        m_undo.pop_front();
+        return;
+    }
+
+    QByteArray raw;
+    QDataStream out(&raw, QIODevice::WriteOnly);
+    qint64 freed = 0;
+    while (m_undo.size() > 1 && m_memory - freed > m_budget / 2) {
+        const Delta &d = m_undo.front();
+        out << d.position << d.removedLength << d.insertedLength << d.removed << d.inserted << d.joined;
+        freed += cost(d);
+        m_undo.pop_front();
+    }
+    m_memory -= freed;
+
+    const QByteArray packed = qCompress(raw);
+    const qint64 offset = m_spillFile.size();
+    m_spillFile.seek(offset);
+    m_spillFile.write(packed);
+    m_segments.append({offset, packed.size()});
+
+    // Límite de disco: se olvidan los segmentos más viejos y, cuando el hueco
+    // que dejan supera a lo vivo, se compacta el fichero
+    qint64 live = m_spillFile.size() - m_segments.first().offset;
+    while (live > MAX_SPILL_BYTES && m_segments.size() > 1) {
+        m_segments.removeFirst();
+        live = m_spillFile.size() - m_segments.first().offset;
+    }
+    const qint64 hole = m_segments.first().offset;
+    if (hole > live) {
+        m_spillFile.seek(hole);
+        const QByteArray data = m_spillFile.read(live);
+        m_spillFile.seek(0);
+        m_spillFile.write(data);
+        m_spillFile.resize(live);
+        for (Segment &s : m_segments) s.offset -= hole;
+    }
+}
+
+// Recupera el segmento más reciente del disco y recorta el fichero
+bool UndoHistory::reload() {
+    if (m_segments.isEmpty()) return false;
+    const Segment s = m_segments.takeLast();
+    m_spillFile.seek(s.offset);
+    const QByteArray raw = qUncompress(m_spillFile.read(s.length));
+    m_spillFile.resize(s.offset);
+
+    std::deque<Delta> batch;
+    QDataStream in(raw);
+    while (!in.atEnd()) {
+        Delta d;
+        in >> d.position >> d.removedLength >> d.insertedLength >> d.removed >> d.inserted >> d.joined;
+        if (in.status() != QDataStream::Ok) break;
+        m_memory += cost(d);
+        batch.push_back(std::move(d));
+    }
+    if (in.status() != QDataStream::Ok || batch.empty()) {
+        clear();
+        return false;
+    }
+    // Los deltas recuperados son anteriores a todo lo que queda en memoria
+    batch.insert(batch.end(), std::make_move_iterator(m_undo.begin()), std::make_move_iterator(m_undo.end()));
+    m_undo.swap(batch);
+    return true;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTemporaryFile>
+#include <QVector>
+#include <deque>
+
+class QTextDocument;
+
+// Historial de deshacer/rehacer propio, en sustitución del de QTextDocument.
+// Guarda solo deltas de texto (posición, borrado, insertado) en UTF-8, sin
+// formatos, agrupa rachas de pulsaciones y respeta un presupuesto de memoria:
+// lo más antiguo se comprime y se vuelca a un fichero temporal que funciona
+// como una pila y se recarga por segmentos al deshacer hasta allí.
+//
+// QTextDocument::contentsChange no entrega el texto borrado, así que quien
+// edita llama antes a prepare() con el rango que puede verse afectado. Un
+// cambio fuera del rango preparado no se puede reconstruir y vacía el historial.
+class UndoHistory : public QObject {
+    Q_OBJECT
+public:
+    explicit UndoHistory(QTextDocument *document);
+
+    void prepare(int from, int to);
+    void clear();
+
+    // Los cambios entre beginGroup() y endGroup() se deshacen y rehacen juntos
+    void beginGroup();
+    void endGroup();
+
+    bool canUndo() const;
+    bool canRedo() const;
+    // Devuelven la posición donde dejar el cursor, o -1 si no había nada
+    int undo();
+    int redo();
+
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryUsage() const { return m_memory; }
+
+    static constexpr qint64 DEFAULT_BUDGET = 32 * 1024 * 1024;
+    static constexpr qint64 MAX_SPILL_BYTES = 512 * 1024 * 1024;
+    static constexpr int COALESCE_MS = 1000;
+
+private slots:
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+
+private:
+    struct Delta {
+        int position = 0;
+        int removedLength = 0;    // en caracteres UTF-16 del documento
+        int insertedLength = 0;
+        QByteArray removed;       // UTF-8
+        QByteArray inserted;      // UTF-8
+        qint64 time = 0;
+        bool joined = false;      // se deshace junto con el anterior
+    };
+    struct Segment {
+        qint64 offset;
+        qint64 length;
+    };
+
+    static qint64 cost(const Delta &d) { return d.removed.size() + d.inserted.size() + 64; }
+    bool coalesce(const QString &removed, const QString &inserted, int position);
+    int apply(const Delta &d, bool undo);
+    void push(Delta d);
+    void spill();
+    bool reload();
+
+    QTextDocument *m_document;
+    std::deque<Delta> m_undo;
+    std::deque<Delta> m_redo;
+    qint64 m_memory = 0;
+    qint64 m_budget = DEFAULT_BUDGET;
+
+    QTemporaryFile m_spillFile;
+    QVector<Segment> m_segments;       // el último es el más reciente
+
+    int m_snapshotFrom = -1;
+    QString m_snapshot;
+    bool m_applying = false;
+    bool m_sealed = true;              // la próxima pulsación no se une a la anterior
+    bool m_grouping = false;
+    bool m_groupStarted = false;
+    QElapsedTimer m_clock;
+};
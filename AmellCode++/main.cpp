@@ -1,8 +1,19 @@
 #include <QApplication>
+#include "CompileCache.h"
 #include "MainWindow.h"
 
 int main(int argc, char *argv[]) {
+    // Lanzado por CMake como CMAKE_<LANG>_COMPILER_LAUNCHER: sin interfaz
+    if (argc > 1 && qstrcmp(argv[1], CompileCache::LAUNCHER_FLAG) == 0) {
+        QCoreApplication app(argc, argv);
+        app.setOrganizationName("ManuelAmell");
+        app.setApplicationName("AmellIDE");
+        return CompileCache::runLauncher(app.arguments().mid(2));
+    }
+
     QApplication app(argc, argv);
+    app.setOrganizationName("ManuelAmell");
+    app.setApplicationName("AmellIDE");
     MainWindow w;
     w.show();
     return app.exec();